@@ -0,0 +1,427 @@
+// Offline asset processing. Block compresses the icons (BC7) and the glyph
+// atlases of the fonts (BC4) found in an assets folder into
+// <assets>/cooked/<file>.gtex. The app prefers these over the source files
+// when the driver supports the formats. Runs as a pre-build step, files
+// that are newer than their source are skipped.
+// --pack then puts the assets and shaders next to the exe into the single
+// archive the app maps at startup, --manifest turns that archive into the
+// typed asset ids of AssetManifest.h.
+#include "BlockCompress.h"
+#include "FontRaster.h"
+#include "TextureFile.h"
+#include "AssetArchive.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <cctype>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+namespace fs = std::filesystem;
+
+enum class AssetKind
+{
+    None,
+    Icon,
+    Font
+};
+
+static AssetKind KindOf(const fs::path& path)
+{
+    std::string ext = path.extension().string();
+    for (char& c : ext)
+        c = (char)std::tolower((unsigned char)c);
+
+    if (ext == ".png")
+        return AssetKind::Icon;
+    if (ext == ".ttf" || ext == ".otf")
+        return AssetKind::Font;
+    return AssetKind::None;
+}
+
+static const char* FormatName(TexFormat format)
+{
+    switch (format)
+    {
+        case TexFormat::RGBA8: return "RGBA8";
+        case TexFormat::R8:    return "R8";
+        case TexFormat::BC4:   return "BC4";
+        case TexFormat::BC7:   return "BC7";
+    }
+    return "?";
+}
+
+static std::vector<unsigned char> ReadWholeFile(const fs::path& path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return {};
+    std::vector<unsigned char> bytes((size_t)file.tellg());
+    file.seekg(0);
+    file.read((char*)bytes.data(), bytes.size());
+    return file ? bytes : std::vector<unsigned char>();
+}
+
+struct PackInput
+{
+    std::string name;  // relative to the root, forward slashes
+    fs::path path;
+    uint64_t hash;
+    uint64_t size;
+};
+
+// Folders below the root that go into the archive
+static const char* s_PackFolders[] = { "assets", "shaders" };
+
+static uint32_t ReadEntryCount(const fs::path& archive)
+{
+    ArchiveHeader header{};
+    std::ifstream file(archive, std::ios::binary);
+    file.read((char*)&header, sizeof(header));
+    if (!file || memcmp(header.magic, kArchiveMagic, 4) != 0 || header.version != kArchiveVersion)
+        return 0;
+    return header.entryCount;
+}
+
+static int Pack(const fs::path& root, const fs::path& out, bool force)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<PackInput> inputs;
+    fs::file_time_type newest = fs::file_time_type::min();
+    for (const char* folder : s_PackFolders)
+    {
+        if (!fs::is_directory(root / folder))
+            continue;
+        for (const fs::directory_entry& entry : fs::recursive_directory_iterator(root / folder))
+        {
+            if (!entry.is_regular_file())
+                continue;
+            PackInput& input = inputs.emplace_back();
+            input.name = fs::relative(entry.path(), root).generic_string();
+            input.path = entry.path();
+            input.hash = AssetHash(input.name);
+            input.size = entry.file_size();
+            newest = std::max(newest, entry.last_write_time());
+        }
+    }
+
+    // The app binary searches the index by hash, so hashes have to be unique
+    std::sort(inputs.begin(), inputs.end(), [](const PackInput& a, const PackInput& b) { return a.hash < b.hash; });
+    for (size_t i = 1; i < inputs.size(); i++)
+    {
+        if (inputs[i].hash == inputs[i - 1].hash)
+        {
+            std::cerr << "[Pack] Hash collision: " << inputs[i - 1].name << " and " << inputs[i].name << std::endl;
+            return 1;
+        }
+    }
+
+    // Deleted files change the count, edited ones the time
+    if (!force && fs::exists(out) && fs::last_write_time(out) >= newest && ReadEntryCount(out) == inputs.size())
+    {
+        std::cout << "[Pack] " << out.string() << " is up to date" << std::endl;
+        return 0;
+    }
+
+    std::vector<ArchiveEntry> index(inputs.size());
+    std::string names;
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        index[i].hash = inputs[i].hash;
+        index[i].size = inputs[i].size;
+        index[i].compression = (uint32_t)AssetCompression::None;
+        index[i].nameOffset = (uint32_t)names.size();
+        names += inputs[i].name;
+        names += '\0';
+    }
+
+    // Data follows the tables in index order, every blob aligned
+    uint64_t offset = sizeof(ArchiveHeader) + sizeof(ArchiveEntry) * index.size() + names.size();
+    for (ArchiveEntry& entry : index)
+    {
+        offset = (offset + kArchiveAlignment - 1) & ~(uint64_t)(kArchiveAlignment - 1);
+        entry.offset = offset;
+        offset += entry.size;
+    }
+
+    ArchiveHeader header{};
+    memcpy(header.magic, kArchiveMagic, 4);
+    header.version = kArchiveVersion;
+    header.entryCount = (uint32_t)index.size();
+    header.nameTableSize = (uint32_t)names.size();
+
+    // Written next to the archive and swapped in, a failed pack leaves the old one intact
+    fs::path temp = out;
+    temp += ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file.write((const char*)&header, sizeof(header));
+        file.write((const char*)index.data(), sizeof(ArchiveEntry) * index.size());
+        file.write(names.data(), names.size());
+        for (size_t i = 0; i < inputs.size() && file; i++)
+        {
+            std::vector<unsigned char> bytes = ReadWholeFile(inputs[i].path);
+            if (bytes.size() != index[i].size)
+            {
+                std::cerr << "[Pack] Failed to read: " << inputs[i].path.string() << std::endl;
+                return 1;
+            }
+            static const char s_Padding[kArchiveAlignment] = {};
+            file.write(s_Padding, index[i].offset - (uint64_t)file.tellp());
+            file.write((const char*)bytes.data(), bytes.size());
+        }
+        if (!file)
+        {
+            std::cerr << "[Pack] Failed to write: " << temp.string() << std::endl;
+            return 1;
+        }
+    }
+
+    std::error_code error;
+    fs::rename(temp, out, error);
+    if (error)
+    {
+        std::cerr << "[Pack] Failed to replace " << out.string() << " (is the app still running?)" << std::endl;
+        fs::remove(temp, error);
+        return 1;
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[Pack] " << inputs.size() << " files, " << offset / 1024 << " KB -> " << out.string()
+              << " (" << ms << " ms)" << std::endl;
+    return 0;
+}
+
+struct ManifestGroup
+{
+    const char* idType;     // enum of the ids
+    const char* table;      // AssetRef array indexed by the id
+    const char* folder;
+    std::vector<const char*> extensions;  // empty takes every file of the folder
+    bool keepExtension;     // shaders differ only by extension
+    bool hasNone;           // the id has a None = -1 member
+};
+
+static const ManifestGroup s_ManifestGroups[] = {
+    { "FontId",   "kFontAssets",   "assets",  { ".ttf", ".otf" },                  false, false },
+    { "IconId",   "kIconAssets",   "assets",  { ".png" },                          false, true  },
+    { "SoundId",  "kSoundAssets",  "assets",  { ".wav", ".ogg", ".mp3", ".flac" }, false, false },
+    { "ShaderId", "kShaderAssets", "shaders", {},                                  true,  false },
+};
+
+// "MS Reference Sans Serif Bold.ttf" -> MsReferenceSansSerifBold
+static std::string MakeIdentifier(const std::string& file, bool keepExtension)
+{
+    std::string stem = keepExtension ? file : fs::path(file).stem().string();
+    std::string id;
+    bool upper = true;
+    for (char c : stem)
+    {
+        if (!std::isalnum((unsigned char)c))
+        {
+            upper = true;
+            continue;
+        }
+        id += upper ? (char)std::toupper((unsigned char)c) : (char)std::tolower((unsigned char)c);
+        upper = false;
+    }
+    if (id.empty() || std::isdigit((unsigned char)id[0]))
+        id = "Asset" + id;
+    return id;
+}
+
+// Only files directly in the group's folder, the cooked files are found through their source
+static bool InGroup(const ManifestGroup& group, const std::string& name)
+{
+    std::string prefix = std::string(group.folder) + "/";
+    if (name.compare(0, prefix.size(), prefix) != 0 || name.find('/', prefix.size()) != std::string::npos)
+        return false;
+    if (group.extensions.empty())
+        return true;
+
+    std::string ext = fs::path(name).extension().string();
+    for (char& c : ext)
+        c = (char)std::tolower((unsigned char)c);
+    for (const char* allowed : group.extensions)
+    {
+        if (ext == allowed)
+            return true;
+    }
+    return false;
+}
+
+static int WriteManifest(const fs::path& archive, const fs::path& out)
+{
+    std::vector<unsigned char> bytes = ReadWholeFile(archive);
+    const ArchiveHeader* header = (const ArchiveHeader*)bytes.data();
+    if (bytes.size() < sizeof(ArchiveHeader) || memcmp(header->magic, kArchiveMagic, 4) != 0 || header->version != kArchiveVersion
+        || bytes.size() < sizeof(ArchiveHeader) + (size_t)header->entryCount * sizeof(ArchiveEntry) + header->nameTableSize)
+    {
+        std::cerr << "[Manifest] Not an asset archive: " << archive.string() << std::endl;
+        return 1;
+    }
+    const ArchiveEntry* index = (const ArchiveEntry*)(bytes.data() + sizeof(ArchiveHeader));
+    const char* names = (const char*)(index + header->entryCount);
+
+    std::ostringstream code;
+    code << "// Generated by AssetCook --manifest from " << archive.filename().string() << ", do not edit.\n"
+         << "// Every asset of the app as a typed id. The ids index the AssetRef tables,\n"
+         << "// whose offsets are valid in the archive with kManifestStamp.\n"
+         << "#pragma once\n"
+         << "#include \"AssetArchive.h\"\n\n"
+         << "inline constexpr uint64_t kManifestStamp = 0x" << std::hex << ArchiveStamp(index, header->entryCount) << std::dec << "ull;\n";
+
+    size_t total = 0;
+    for (const ManifestGroup& group : s_ManifestGroups)
+    {
+        std::vector<const ArchiveEntry*> entries;
+        for (uint32_t i = 0; i < header->entryCount; i++)
+        {
+            if (InGroup(group, names + index[i].nameOffset))
+                entries.push_back(&index[i]);
+        }
+        std::sort(entries.begin(), entries.end(), [names](const ArchiveEntry* a, const ArchiveEntry* b) {
+            std::string nameA = names + a->nameOffset, nameB = names + b->nameOffset;
+            return std::lexicographical_compare(nameA.begin(), nameA.end(), nameB.begin(), nameB.end(), [](char x, char y) {
+                return std::tolower((unsigned char)x) < std::tolower((unsigned char)y);
+            });
+        });
+
+        std::vector<std::string> ids;
+        for (const ArchiveEntry* entry : entries)
+        {
+            std::string name = names + entry->nameOffset;
+            std::string id = MakeIdentifier(name.substr(name.find('/') + 1), group.keepExtension);
+            if (std::find(ids.begin(), ids.end(), id) != ids.end())
+            {
+                std::cerr << "[Manifest] Two " << group.idType << " assets map to " << id << ", rename one of them: " << name << std::endl;
+                return 1;
+            }
+            ids.push_back(id);
+        }
+
+        code << "\nenum class " << group.idType << "\n{\n";
+        if (group.hasNone)
+            code << "    None = -1,\n";
+        for (const std::string& id : ids)
+            code << "    " << id << ",\n";
+        code << "    Count\n};\n\n";
+
+        // A zero sized array isn't allowed, an empty group gets one unused entry
+        code << "inline constexpr AssetRef " << group.table << "[] = {\n";
+        for (const ArchiveEntry* entry : entries)
+        {
+            std::string name = names + entry->nameOffset;
+            code << "    { \"" << name << "\", AssetHash(\"" << name << "\"), " << entry->offset << ", " << entry->size << " },\n";
+        }
+        if (entries.empty())
+            code << "    { \"\", 0, 0, 0 },\n";
+        code << "};\n\n";
+        code << "constexpr const AssetRef& GetAsset(" << group.idType << " id) { return " << group.table << "[(int)id]; }\n";
+        total += entries.size();
+    }
+
+    // Left alone when nothing changed, so the app doesn't rebuild every time
+    std::string text = code.str();
+    std::vector<unsigned char> previous = ReadWholeFile(out);
+    if (std::string(previous.begin(), previous.end()) == text)
+    {
+        std::cout << "[Manifest] " << out.string() << " is up to date" << std::endl;
+        return 0;
+    }
+
+    std::ofstream file(out, std::ios::binary | std::ios::trunc);
+    file << text;
+    if (!file)
+    {
+        std::cerr << "[Manifest] Failed to write: " << out.string() << std::endl;
+        return 1;
+    }
+    std::cout << "[Manifest] " << total << " assets -> " << out.string() << std::endl;
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc >= 4 && strcmp(argv[1], "--pack") == 0)
+        return Pack(argv[2], argv[3], argc > 4 && strcmp(argv[4], "--force") == 0);
+    if (argc >= 4 && strcmp(argv[1], "--manifest") == 0)
+        return WriteManifest(argv[2], argv[3]);
+
+    if (argc < 2)
+    {
+        std::cerr << "usage: AssetCook <assets folder> [--force]" << std::endl;
+        std::cerr << "       AssetCook --pack <root folder> <archive> [--force]" << std::endl;
+        std::cerr << "       AssetCook --manifest <archive> <header>" << std::endl;
+        return 1;
+    }
+    fs::path root = argv[1];
+    bool force = argc > 2 && strcmp(argv[2], "--force") == 0;
+
+    if (!fs::is_directory(root))
+    {
+        std::cerr << "[Cook] No such folder: " << root.string() << std::endl;
+        return 1;
+    }
+    fs::create_directories(root / "cooked");
+
+    int cooked = 0, upToDate = 0, failed = 0;
+    for (const fs::directory_entry& entry : fs::directory_iterator(root))
+    {
+        if (!entry.is_regular_file())
+            continue;
+        AssetKind kind = KindOf(entry.path());
+        if (kind == AssetKind::None)
+            continue;
+
+        std::string file = entry.path().filename().string();
+        fs::path out = root / CookedName(file);
+        if (!force && fs::exists(out) && fs::last_write_time(out) >= entry.last_write_time())
+        {
+            upToDate++;
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<unsigned char> bytes = ReadWholeFile(entry.path());
+        TextureData source;
+        if (!bytes.empty())
+        {
+            source = kind == AssetKind::Icon
+                ? DecodeIcon(bytes.data(), bytes.size(), kIconLayerSize)
+                : BuildGlyphAtlas(RasterizeFont(bytes.data(), bytes.size(), kFontPixelSize));
+        }
+        if (source.IsEmpty())
+        {
+            std::cerr << "[Cook] Failed to load: " << file << std::endl;
+            failed++;
+            continue;
+        }
+
+        TextureData result = kind == AssetKind::Icon ? CompressBC7(source) : CompressBC4(source);
+        if (!WriteTextureFile(out.string(), result))
+        {
+            std::cerr << "[Cook] Failed to write: " << out.string() << std::endl;
+            failed++;
+            continue;
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "[Cook] " << file << ": "
+                  << FormatName(source.format) << " " << source.pixels.size() / 1024 << " KB -> "
+                  << FormatName(result.format) << " " << result.pixels.size() / 1024 << " KB ("
+                  << result.layers << " layers, " << result.levels << " levels, " << ms << " ms)" << std::endl;
+        cooked++;
+    }
+
+    std::cout << "[Cook] " << cooked << " cooked, " << upToDate << " up to date, " << failed << " failed" << std::endl;
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,292 @@
+#include "BlockCompress.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <climits>
+
+// Interpolation weights of 4 bit BC7 indices, out of 64
+static const int kBC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// BC blocks are filled least significant bit first
+struct BitWriter
+{
+    unsigned char* out;
+    int pos = 0;
+
+    void Write(uint32_t value, int bits)
+    {
+        for (int i = 0; i < bits; i++, pos++)
+        {
+            if ((value >> i) & 1)
+                out[pos >> 3] |= (unsigned char)(1 << (pos & 7));
+        }
+    }
+};
+
+struct BC7Endpoints
+{
+    int q[2][4];  // 7 bit per channel
+    int p[2];     // shared lsb per endpoint
+
+    int Value(int e, int c) const { return (q[e][c] << 1) | p[e]; }
+};
+
+// Best 7 bit + p-bit representation of an 8 bit RGBA endpoint
+static void QuantizeEndpoint(const float color[4], int q[4], int& p)
+{
+    float bestError = 1e30f;
+    for (int bit = 0; bit < 2; bit++)
+    {
+        int candidate[4];
+        float error = 0.0f;
+        for (int c = 0; c < 4; c++)
+        {
+            candidate[c] = std::clamp((int)std::lround((color[c] - bit) * 0.5f), 0, 127);
+            float d = (float)((candidate[c] << 1) | bit) - color[c];
+            error += d * d;
+        }
+        if (error < bestError)
+        {
+            bestError = error;
+            p = bit;
+            memcpy(q, candidate, sizeof(candidate));
+        }
+    }
+}
+
+// Picks the nearest palette entry for every texel, returns the total squared error
+static int FindBC7Indices(const unsigned char texels[16][4], const BC7Endpoints& ep, int indices[16])
+{
+    int palette[16][4];
+    for (int i = 0; i < 16; i++)
+    {
+        for (int c = 0; c < 4; c++)
+            palette[i][c] = ((64 - kBC7Weights[i]) * ep.Value(0, c) + kBC7Weights[i] * ep.Value(1, c) + 32) >> 6;
+    }
+
+    int total = 0;
+    for (int t = 0; t < 16; t++)
+    {
+        int bestError = INT_MAX;
+        for (int i = 0; i < 16; i++)
+        {
+            int error = 0;
+            for (int c = 0; c < 4; c++)
+            {
+                int d = palette[i][c] - texels[t][c];
+                error += d * d;
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                indices[t] = i;
+            }
+        }
+        total += bestError;
+    }
+    return total;
+}
+
+static void EncodeBC7Block(const unsigned char texels[16][4], unsigned char out[16])
+{
+    // Principal axis of the block through a few power iterations
+    float mean[4] = {};
+    for (int t = 0; t < 16; t++)
+        for (int c = 0; c < 4; c++)
+            mean[c] += texels[t][c] / 16.0f;
+
+    float cov[4][4] = {};
+    for (int t = 0; t < 16; t++)
+    {
+        float d[4];
+        for (int c = 0; c < 4; c++)
+            d[c] = texels[t][c] - mean[c];
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+                cov[i][j] += d[i] * d[j];
+    }
+
+    float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    for (int iteration = 0; iteration < 8; iteration++)
+    {
+        float next[4] = {};
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+                next[i] += cov[i][j] * axis[j];
+        float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2] + next[3] * next[3]);
+        if (length < 1e-6f)
+            break;
+        for (int i = 0; i < 4; i++)
+            axis[i] = next[i] / length;
+    }
+
+    float minT = 0.0f, maxT = 0.0f;
+    for (int t = 0; t < 16; t++)
+    {
+        float proj = 0.0f;
+        for (int c = 0; c < 4; c++)
+            proj += (texels[t][c] - mean[c]) * axis[c];
+        minT = std::min(minT, proj);
+        maxT = std::max(maxT, proj);
+    }
+
+    float ends[2][4];
+    for (int c = 0; c < 4; c++)
+    {
+        ends[0][c] = std::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+        ends[1][c] = std::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+    }
+
+    BC7Endpoints ep;
+    QuantizeEndpoint(ends[0], ep.q[0], ep.p[0]);
+    QuantizeEndpoint(ends[1], ep.q[1], ep.p[1]);
+    int indices[16];
+    int error = FindBC7Indices(texels, ep, indices);
+
+    // One least squares refit of the endpoints against the chosen indices
+    float a = 0.0f, b = 0.0f, d = 0.0f;
+    float x[4] = {}, y[4] = {};
+    for (int t = 0; t < 16; t++)
+    {
+        float w = kBC7Weights[indices[t]] / 64.0f;
+        a += (1.0f - w) * (1.0f - w);
+        b += (1.0f - w) * w;
+        d += w * w;
+        for (int c = 0; c < 4; c++)
+        {
+            x[c] += (1.0f - w) * texels[t][c];
+            y[c] += w * texels[t][c];
+        }
+    }
+    float det = a * d - b * b;
+    if (std::fabs(det) > 1e-6f)
+    {
+        float refit[2][4];
+        for (int c = 0; c < 4; c++)
+        {
+            refit[0][c] = std::clamp((d * x[c] - b * y[c]) / det, 0.0f, 255.0f);
+            refit[1][c] = std::clamp((a * y[c] - b * x[c]) / det, 0.0f, 255.0f);
+        }
+        BC7Endpoints candidate;
+        QuantizeEndpoint(refit[0], candidate.q[0], candidate.p[0]);
+        QuantizeEndpoint(refit[1], candidate.q[1], candidate.p[1]);
+        int candidateIndices[16];
+        int candidateError = FindBC7Indices(texels, candidate, candidateIndices);
+        if (candidateError < error)
+        {
+            ep = candidate;
+            memcpy(indices, candidateIndices, sizeof(indices));
+        }
+    }
+
+    // The first index is stored with 3 bits, its top bit has to be zero
+    if (indices[0] >= 8)
+    {
+        std::swap(ep.q[0], ep.q[1]);
+        std::swap(ep.p[0], ep.p[1]);
+        for (int t = 0; t < 16; t++)
+            indices[t] = 15 - indices[t];
+    }
+
+    memset(out, 0, 16);
+    BitWriter bits{ out };
+    bits.Write(1 << 6, 7);  // mode 6
+    for (int c = 0; c < 4; c++)
+    {
+        bits.Write(ep.q[0][c], 7);
+        bits.Write(ep.q[1][c], 7);
+    }
+    bits.Write(ep.p[0], 1);
+    bits.Write(ep.p[1], 1);
+    bits.Write(indices[0], 3);
+    for (int t = 1; t < 16; t++)
+        bits.Write(indices[t], 4);
+}
+
+static void EncodeBC4Block(const unsigned char texels[16], unsigned char out[8])
+{
+    unsigned char hi = *std::max_element(texels, texels + 16);
+    unsigned char lo = *std::min_element(texels, texels + 16);
+
+    memset(out, 0, 8);
+    out[0] = hi;
+    out[1] = lo;
+    if (hi == lo)
+        return; // every index 0
+
+    // hi > lo selects the 8 value mode: hi, lo, then six steps from hi to lo
+    int palette[8] = { hi, lo };
+    for (int i = 2; i < 8; i++)
+        palette[i] = ((8 - i) * hi + (i - 1) * lo) / 7;
+
+    BitWriter bits{ out + 2 };
+    for (int t = 0; t < 16; t++)
+    {
+        int best = 0;
+        for (int i = 1; i < 8; i++)
+        {
+            if (std::abs(palette[i] - texels[t]) < std::abs(palette[best] - texels[t]))
+                best = i;
+        }
+        bits.Write(best, 3);
+    }
+}
+
+// Runs encode(texels, out) for every 4x4 block of every level and layer
+template <int Channels, typename Encoder>
+static TextureData CompressBlocks(const TextureData& src, TexFormat format, int blockBytes, Encoder encode)
+{
+    TextureData dst;
+    dst.format = format;
+    dst.width  = src.width;
+    dst.height = src.height;
+    dst.layers = src.layers;
+    dst.levels = src.levels;
+    dst.glyphs = src.glyphs;
+    dst.pixels.resize(TexTotalSize(dst));
+
+    for (int level = 0; level < src.levels; level++)
+    {
+        int width = std::max(src.width >> level, 1);
+        int height = std::max(src.height >> level, 1);
+        for (int layer = 0; layer < src.layers; layer++)
+        {
+            const unsigned char* in = src.pixels.data() + TexLevelOffset(src, level, layer);
+            unsigned char* out = dst.pixels.data() + TexLevelOffset(dst, level, layer);
+
+            for (int by = 0; by < (height + 3) / 4; by++)
+            {
+                for (int bx = 0; bx < (width + 3) / 4; bx++)
+                {
+                    unsigned char texels[16][Channels];
+                    for (int y = 0; y < 4; y++)
+                    {
+                        for (int x = 0; x < 4; x++)
+                        {
+                            int sx = std::min(bx * 4 + x, width - 1);
+                            int sy = std::min(by * 4 + y, height - 1);
+                            memcpy(texels[y * 4 + x], in + ((size_t)sy * width + sx) * Channels, Channels);
+                        }
+                    }
+                    encode(texels, out);
+                    out += blockBytes;
+                }
+            }
+        }
+    }
+    return dst;
+}
+
+TextureData CompressBC7(const TextureData& rgba)
+{
+    return CompressBlocks<4>(rgba, TexFormat::BC7, 16, [](const unsigned char texels[16][4], unsigned char* out) {
+        EncodeBC7Block(texels, out);
+    });
+}
+
+TextureData CompressBC4(const TextureData& r8)
+{
+    return CompressBlocks<1>(r8, TexFormat::BC4, 8, [](const unsigned char texels[16][1], unsigned char* out) {
+        EncodeBC4Block(&texels[0][0], out);
+    });
+}
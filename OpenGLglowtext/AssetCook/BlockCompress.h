@@ -0,0 +1,11 @@
+#pragma once
+#include "TextureFile.h"
+
+// Offline block encoders, every level and layer of the input is encoded.
+// Levels smaller than 4x4 are padded by repeating their edge texels.
+
+// RGBA8 -> BC7, mode 6 only (one subset, RGBA endpoints, 4 bit indices)
+TextureData CompressBC7(const TextureData& rgba);
+
+// R8 -> BC4
+TextureData CompressBC4(const TextureData& r8);
@@ -0,0 +1,183 @@
+#include "AllocTracker.h"
+
+#ifdef NOTIFY_ALLOC_TRACKING
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <new>
+
+#ifdef __linux__
+#include <dlfcn.h>
+#include <execinfo.h>
+#endif
+
+static std::atomic<bool> s_Armed = false;
+static std::atomic<uint64_t> s_Count = 0;
+static thread_local bool t_Tracked = false;
+static thread_local int t_Paused = 0;
+
+#ifdef __linux__
+// The GL driver lives in the same process here (llvmpipe JITs its shaders
+// with LLVM), and its operator new calls, direct or through the standard
+// library, land in ours. An allocation only counts when no frame of its
+// call stack belongs to a library other than the app, libstdc++ and libc.
+static const void* s_AppModule = nullptr;
+static const void* s_StdModule = nullptr;
+static const void* s_LibcModule = nullptr;
+
+static const void* ModuleOf(const void* address)
+{
+    Dl_info info;
+    return dladdr(address, &info) ? info.dli_fbase : nullptr;
+}
+
+static bool IsAppAllocation()
+{
+    void* frames[64];
+    int count = backtrace(frames, 64);
+    for (int i = 0; i < count; i++)
+    {
+        const void* module = ModuleOf(frames[i]);
+        if (module && module != s_AppModule && module != s_StdModule && module != s_LibcModule)
+            return false;
+    }
+    return true;
+}
+#else
+// Drivers are DLLs with their own heap, everything that gets here is the app's
+static bool IsAppAllocation()
+{
+    return true;
+}
+#endif
+
+void AllocTracker::TrackThisThread()
+{
+    if (t_Tracked)
+        return;
+#ifdef __linux__
+    if (!s_AppModule)
+    {
+        s_AppModule = ModuleOf((const void*)&AllocTracker::TakeCount);
+        s_StdModule = ModuleOf((const void*)&std::terminate);
+        s_LibcModule = ModuleOf((const void*)&malloc);
+    }
+    // The first backtrace() loads the unwinder, not from inside operator new
+    void* frame;
+    backtrace(&frame, 1);
+#endif
+    t_Tracked = true;
+}
+
+void AllocTracker::SetArmed(bool armed)
+{
+    s_Armed = armed;
+}
+
+uint64_t AllocTracker::TakeCount()
+{
+    return s_Count.exchange(0);
+}
+
+AllocPause::AllocPause()
+{
+    t_Paused++;
+}
+
+AllocPause::~AllocPause()
+{
+    t_Paused--;
+}
+
+static void* Allocate(size_t size)
+{
+    if (t_Tracked && t_Paused == 0 && s_Armed.load(std::memory_order_relaxed) && IsAppAllocation())
+        s_Count.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+
+static void* AllocateAligned(size_t size, std::align_val_t alignment)
+{
+    if (t_Tracked && t_Paused == 0 && s_Armed.load(std::memory_order_relaxed) && IsAppAllocation())
+        s_Count.fetch_add(1, std::memory_order_relaxed);
+    size_t align = (size_t)alignment;
+    size = size ? size : 1;
+#ifdef _WIN32
+    return _aligned_malloc(size, align);
+#else
+    return aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+}
+
+static void FreeAligned(void* p)
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+// Every form is replaced, the array and nothrow ones would reach the plain
+// operator new anyway but have to match the frees below
+void* operator new(size_t size)
+{
+    if (void* p = Allocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    if (void* p = Allocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return Allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    if (void* p = AllocateAligned(size, alignment))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    if (void* p = AllocateAligned(size, alignment))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateAligned(size, alignment);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(p); }
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+
+// Test hook for the zero allocation frame path. Built with
+// NOTIFY_ALLOC_TRACKING, the global operator new counts every allocation
+// made by a tracked thread while tracking is armed. Without the define the
+// calls are empty and operator new is left alone.
+class AllocTracker
+{
+public:
+#ifdef NOTIFY_ALLOC_TRACKING
+    static constexpr bool kEnabled = true;
+
+    // Counts the allocations of the calling thread from now on
+    static void TrackThisThread();
+    static void SetArmed(bool armed);
+    // Allocations counted since the last call
+    static uint64_t TakeCount();
+#else
+    static constexpr bool kEnabled = false;
+
+    static void TrackThisThread() {}
+    static void SetArmed(bool) {}
+    static uint64_t TakeCount() { return 0; }
+#endif
+};
+
+// Allocations of the current thread aren't counted while one exists, for
+// work that is allowed to allocate (loading, enqueueing a notification)
+class AllocPause
+{
+public:
+#ifdef NOTIFY_ALLOC_TRACKING
+    AllocPause();
+    ~AllocPause();
+#else
+    AllocPause() {}
+#endif
+
+    AllocPause(const AllocPause&) = delete;
+    AllocPause& operator=(const AllocPause&) = delete;
+};
@@ -1,76 +1,107 @@
-#define MINIAUDIO_IMPLEMENTATION
-#include "miniaudio.h"
-
 #include "Application.h"
 #include "WinWindow.h"
+#include "HeadlessWindow.h"
+#include "Platform.h"
 #include "Shader.h"
+#include "RenderThread.h"
+#include "JobSystem.h"
+#include "SoundBank.h"
+#include "AudioCues.h"
+#include "TextureLoader.h"
+#include "QuadBatch.h"
+#include "FontRaster.h"
+#include "AssetArchive.h"
+#include "FrameArena.h"
+#include "AllocTracker.h"
+#include "GpuTimer.h"
+#include "CpuProfiler.h"
+#include "SessionLog.h"
+#include "RenderBench.h"
 #include <glad/glad.h>
-#include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-
-#include <ft2build.h>
-#include FT_FREETYPE_H
-
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-
-ma_engine engine;
-
-static std::map<char, Character> s_Characters;
-static GLuint s_VAO, s_VBO;
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <thread>
+
+// One glyph set per font once it is loaded, s_Characters points at the active one
+static std::optional<std::map<char, Character>> s_FontCache[(int)FontId::Count];
+static std::map<char, Character>* s_Characters = nullptr;
+static QuadBatch* s_Batch;
+static AssetArchive* s_Assets;
 static Shader* s_TextShader;
-static Shader* s_BlurShader;
-static WinWindow* s_Window;
+static PlatformWindow* s_Window;
 static glm::mat4 s_Projection;
+static StartupReport s_Startup;
 
-std::string curFontType;
-
-struct DecayEntry
-{
-    int index;
-    float startTime;
-};
+FontId curFontType = FontId::Count; // Count until the first SetFont
 
 std::vector<DecayEntry> decayOrder;
+PulseTextFX g_PulseTextFX;
 
+// Layout units. The projection maps them onto the framebuffer, whatever its size.
+static const float kViewWidth = 1280.0f;
+static const float kViewHeight = 720.0f;
+
+// How often the simulation side polls input and publishes a frame packet
+static const double kSimTickSeconds = 1.0 / 240.0;
+
+// The announcer line starts after the notification's own sound effect
+static const double kAnnouncerOffset = 0.35;
+
+// Texture streaming priority of icons waiting in the notification queue
+static const int kQueuedIconPriority = 10;
+
+// Transient data of one simulation tick (cue lists, the decay shuffle)
+static const size_t kFrameArenaSize = 16 * 1024;
+
+// How often --gpu-timing-out rewrites / appends to its file
+static const double kGpuDumpSeconds = 5.0;
+
+// What one frame of each kind may ask of GL with --check-budgets, loading
+// (uploads of fonts and icons, building a pipeline) isn't part of it
+static const FrameBudget kFrameBudgets[(int)FrameScenario::Count] = {
+    // Nothing on screen is a clear
+    { "idle",       { .clears = 1 } },
+    // Mask, glow, title + icon, description. The uploads are the batched quads, 64 KiB covers the longest text.
+    { "splash",     { .drawCalls = 8, .bufferUploads = 8, .uploadBytes = 64 * 1024, .textureBinds = 16, .programBinds = 8,
+                      .uniformSets = 8, .framebufferBinds = 4, .clears = 3, .blendChanges = 6 } },
+    { "killstreak", { .drawCalls = 8, .bufferUploads = 8, .uploadBytes = 64 * 1024, .textureBinds = 16, .programBinds = 8,
+                      .uniformSets = 8, .framebufferBinds = 4, .clears = 3, .blendChanges = 6 } },
+    // Mask, glow, text
+    { "typewriter", { .drawCalls = 6, .bufferUploads = 6, .uploadBytes = 32 * 1024, .textureBinds = 12, .programBinds = 6,
+                      .uniformSets = 6, .framebufferBinds = 4, .clears = 3, .blendChanges = 6 } },
+    { "glow pulse", { .drawCalls = 6, .bufferUploads = 6, .uploadBytes = 32 * 1024, .textureBinds = 12, .programBinds = 6,
+                      .uniformSets = 6, .framebufferBinds = 4, .clears = 3, .blendChanges = 6 } },
+};
 
-std::string GetExecutableDirectory()
+static FrameScenario GetScenario(const FramePacket& packet)
 {
-    HMODULE hModule = NULL;
-    GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)&GetExecutableDirectory, &hModule);
-
-    char path[MAX_PATH];
-    GetModuleFileNameA(hModule, path, MAX_PATH);
-
-    std::string fullPath(path);
-    return fullPath.substr(0, fullPath.find_last_of("\\/"));
+    if (packet.drawSplash)
+        return std::holds_alternative<KillstreakStyle>(packet.splash.style) ? FrameScenario::Killstreak : FrameScenario::Splash;
+    if (packet.drawPulseText)
+        return FrameScenario::Typewriter;
+    if (packet.state == NotifyState::Pulse)
+        return FrameScenario::GlowPulse;
+    return FrameScenario::Idle;
 }
-std::string g_AssetRoot = GetExecutableDirectory() + "/assets";
 
-std::string AssetPath(const std::string& relative)
-{
-    return g_AssetRoot + "/" + relative;
-}
 
-static glm::vec2 MeasureText(const std::string& text, float scale)
+// Name of a file of the assets folder in the asset archive
+std::string AssetName(std::string_view file)
 {
-    float width = 0.0f;
-    float maxHeight = 0.0f;
-
-    for (char c : text)
-    {
-        const Character& ch = s_Characters[c];
-        width += (ch.Advance >> 6) * scale;
-        maxHeight = std::max(maxHeight, ch.Size.y * scale);
-    }
-    return { width, maxHeight };
+    return "assets/" + std::string(file);
 }
 
-static void RenderText(Shader* shader, const std::string& text, float x, float y, float scale, TextAlignX alignX, TextAlignY alignY, float padding = 0.0f)
+// size is the already measured text at this scale
+static void RenderText(std::string_view text, glm::vec2 size, float x, float y, float scale, TextAlignX alignX, TextAlignY alignY, const glm::vec3& color, float padding = 0.0f)
 {
-    glm::vec2 size = MeasureText(text, scale);
-
+    PROFILE_ZONE("RenderText");
     // X alignment
     if (alignX == TextAlignX::Center)
         x -= size.x * 0.5f;
@@ -83,14 +114,13 @@ static void RenderText(Shader* shader, const std::string& text, float x, float y
     else if (alignY == TextAlignY::Top)
         y -= size.y;
 
-    shader->Bind();
-
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(s_VAO);
-
     for (char c : text)
     {
-        Character ch = s_Characters[c];
+        // Not in the atlas (UTF-8 bytes), drawn as nothing like MeasureText measures it
+        auto it = s_Characters->find(c);
+        if (it == s_Characters->end())
+            continue;
+        const Character& ch = it->second;
 
         if (ch.TextureID == 0) // space / empty glyph
         {
@@ -104,34 +134,55 @@ static void RenderText(Shader* shader, const std::string& text, float x, float y
 
         // Adding padding to geometry
         float p = padding * scale;
-        float x_pad = xpos - p;
-        float y_pad = ypos - p;
-        float w_pad = w + p * 2.0f;
-        float h_pad = h + p * 2.0f;
-
-        // Correcting UV coordinates for padding
-        float u_pad = (ch.Size.x > 0) ? padding / (float)ch.Size.x : 0.0f;
-        float v_pad = (ch.Size.y > 0) ? padding / (float)ch.Size.y : 0.0f;
-        float vertices[6][4] = {
-            { x_pad,         y_pad + h_pad,   -u_pad,         -v_pad },
-            { x_pad,         y_pad,           -u_pad,          1.0f + v_pad },
-            { x_pad + w_pad, y_pad,            1.0f + u_pad,   1.0f + v_pad },
-
-            { x_pad,         y_pad + h_pad,   -u_pad,         -v_pad },
-            { x_pad + w_pad, y_pad,            1.0f + u_pad,   1.0f + v_pad },
-            { x_pad + w_pad, y_pad + h_pad,    1.0f + u_pad,  -v_pad }
-        };
-
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-        glNamedBufferSubData(s_VBO, 0, sizeof(vertices), vertices);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+
+        // Correcting UV coordinates for padding, the empty margin around
+        // the glyph in its layer takes the place of the old border color
+        float u_pad = padding / (float)ch.Size.x;
+        float v_pad = padding / (float)ch.Size.y;
+        glm::vec2 uv0 = ch.UVOrigin + glm::vec2(-u_pad, -v_pad) * ch.UVSize;
+        glm::vec2 uv1 = ch.UVOrigin + glm::vec2(1.0f + u_pad, 1.0f + v_pad) * ch.UVSize;
+
+        s_Batch->SetGlyphTexture(ch.TextureID);
+        s_Batch->AddGlyph(xpos - p, ypos - p, w + p * 2.0f, h + p * 2.0f, uv0, uv1, ch.Layer, color);
 
         x += (ch.Advance >> 6) * scale;
     }
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
+static void RenderText(std::string_view text, float x, float y, float scale, TextAlignX alignX, TextAlignY alignY, const glm::vec3& color, float padding = 0.0f)
+{
+    RenderText(text, MeasureText(*s_Characters, text, scale, false), x, y, scale, alignX, alignY, color, padding);
+}
+
+// One GPU timing scope of a draw, nothing without a timer. The batch is
+// flushed on both ends so the pass's quads are drawn inside it; while
+// timing, the title and its icon take two draws instead of one.
+class GpuPass
+{
+public:
+    GpuPass(GpuTimer* timer, const char* name)
+        : m_Timer(timer)
+    {
+        if (!m_Timer)
+            return;
+        s_Batch->Flush();
+        m_Timer->Begin(name);
+    }
+    ~GpuPass()
+    {
+        if (!m_Timer)
+            return;
+        s_Batch->Flush();
+        m_Timer->End();
+    }
+
+    GpuPass(const GpuPass&) = delete;
+    GpuPass& operator=(const GpuPass&) = delete;
+
+private:
+    GpuTimer* m_Timer;
+};
+
 void Application::InitFBO(int width, int height) {
     m_Width = width;
     m_Height = height;
@@ -152,7 +203,8 @@ void Application::InitFBO(int width, int height) {
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
         std::cerr << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << std::endl;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0); // Return to normal screen
+    glBindFramebuffer(GL_FRAMEBUFFER, s_Window->GetFramebuffer()); // Return to normal screen
+    GL_CHECK("InitFBO");
 }
 
 void Application::InitScreenQuad() {
@@ -181,45 +233,76 @@ void Application::RenderScreenQuad() {
     glBindVertexArray(0);
 }
 
-void LoadFont(FT_Library ft, const std::string& path, int pixelSize)
-{
-    FT_Face face;
+// What each font of the manifest is used for
+static constexpr FontId kFontBold      = FontId::MsReferenceSansSerifBold;
+static constexpr FontId kFontExtraBig  = FontId::BankGothicMediumBt;
+static constexpr FontId kFontObjective = FontId::CarbonBold;
+static constexpr FontId kFontDefault   = FontId::ConduitItcStdFont;
 
-    FT_New_Face(ft, path.c_str(), 0, &face);
-    FT_Set_Pixel_Sizes(face, 0, pixelSize); // face, pixel_width, pixel_height
+// Set once the GL context is up, the cooked BC4 atlases are used when true
+static bool s_CookedFonts = false;
 
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+enum class PrefetchKind
+{
+    Audio,
+    TextPipeline,
+    GlowPipeline,
+    Font,
+    Icon
+};
 
-    for (unsigned char c = 32; c < 128; c++)
-    {
-        FT_Load_Char(face, c, FT_LOAD_RENDER);
-        int w = face->glyph->bitmap.width;
-        int h = face->glyph->bitmap.rows;
+struct PrefetchItem
+{
+    PrefetchKind kind;
+    FontId font;
+    IconId icon;
+};
 
-        if (w == 0 || h == 0)
-        {
-        	// space or empty glyph
-            s_Characters[c] = {
-                0,
-                { 0, 0 },
-                { face->glyph->bitmap_left, face->glyph->bitmap_top },
-                (GLuint)(face->glyph->advance.x >> 6)
-            };
-            continue;
-        }
+// Warmed one at a time while nothing is on screen, roughly in the order the
+// first notification needs them. The text pipeline brings kFontObjective along.
+static const PrefetchItem s_IdlePrefetch[] = {
+    { PrefetchKind::Audio,        FontId::Count, IconId::None },
+    { PrefetchKind::TextPipeline, FontId::Count, IconId::None },
+    { PrefetchKind::GlowPipeline, FontId::Count, IconId::None },
+    { PrefetchKind::Font,         kFontBold,     IconId::None },
+    { PrefetchKind::Font,         kFontDefault,  IconId::None },
+    { PrefetchKind::Icon,         FontId::Count, IconId::CrosshairRed },
+    { PrefetchKind::Font,         kFontExtraBig, IconId::None },
+    { PrefetchKind::Icon,         FontId::Count, IconId::CompassObjpointSatallite },
+};
 
-        GLuint tex;
-        glCreateTextures(GL_TEXTURE_2D, 1, &tex);
-        glTextureStorage2D(tex, 1, GL_R8,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows);
+// CPU only, safe to run on any thread. Takes the atlas cooked by AssetCook
+// when there is one, otherwise rasterizes the font now.
+TextureData LoadFontAtlas(FontId id)
+{
+    const AssetRef& asset = GetAsset(id);
+    PROFILE_ZONE_DETAIL("LoadFont", asset.name);
+    FlightMark mark("font load", asset.name);
+    TextureData atlas;
+    AssetBlob cooked = s_CookedFonts ? s_Assets->Load(AssetName(CookedName(asset.File()))) : AssetBlob{};
+    if (cooked && ReadTextureFile(cooked.data, cooked.size, atlas) && atlas.format == TexFormat::BC4)
+        return atlas;
+
+    AssetBlob font = s_Assets->Load(asset);
+    if (!font)
+    {
+        std::cerr << "[Font] Failed to load: " << asset.name << std::endl;
+        return {};
+    }
+    return BuildGlyphAtlas(RasterizeFont(font.data, font.size, kFontPixelSize));
+}
 
-        glTextureSubImage2D(
-            tex, 0, 0, 0,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            GL_RED, GL_UNSIGNED_BYTE,
-            face->glyph->bitmap.buffer);
+// Needs the GL context. Every glyph of a font is one layer of the same
+// texture array, so text and icons can go out in one draw.
+std::map<char, Character> UploadFont(const TextureData& atlas, FontId id)
+{
+    PROFILE_ZONE("UploadFont");
+    FlightMark mark("font upload", GetAsset(id).name);
+    GLuint tex = 0;
+    if (!atlas.IsEmpty())
+    {
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &tex);
+        glTextureStorage3D(tex, 1, TextureLoader::GetInternalFormat(atlas.format), atlas.width, atlas.height, atlas.layers);
 
         glTextureParameteri(tex, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTextureParameteri(tex, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -230,153 +313,402 @@ void LoadFont(FT_Library ft, const std::string& path, int pixelSize)
         float borderColor[] = { 0.0f, 0.0f, 0.0f, 0.0f };
         glTextureParameterfv(tex, GL_TEXTURE_BORDER_COLOR, borderColor);
 
-        s_Characters[c] = {
-            tex,
-            { face->glyph->bitmap.width, face->glyph->bitmap.rows },
-            { face->glyph->bitmap_left, face->glyph->bitmap_top },
-            (GLuint)face->glyph->advance.x
-        };
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        TextureLoader::UploadLevels(tex, atlas, 0, atlas.Data());
+        GL_CHECK("UploadFont");
+    }
+
+    return BuildCharacters(atlas, tex);
+}
+
+// Render thread
+static std::map<char, Character>& GetFont(FontId id, InitTrigger trigger = InitTrigger::FirstUse)
+{
+    std::optional<std::map<char, Character>>& font = s_FontCache[(int)id];
+    if( !font )
+    {
+        // Not prefetched (yet), load it synchronously
+        double start = StartupReport::Now();
+        font = UploadFont(LoadFontAtlas(id), id);
+        s_Startup.AddInit(std::string("font ") + GetAsset(id).File(), trigger, start, StartupReport::Now());
     }
-    FT_Done_Face(face);
+    return *font;
 }
 
-void SetFont(const std::string name)
+void SetFont(FontId id, InitTrigger trigger = InitTrigger::FirstUse)
 {
-    if( curFontType == name )
+    if( curFontType == id )
         return;
-    curFontType = name;
-    FT_Library ft;
-    FT_Init_FreeType(&ft);
 
-    if( name == "bold" )
+    curFontType = id;
+    s_Characters = &GetFont(id, trigger);
+
+    //std::cout << "Font type changed" << std::endl; // DEV
+}
+
+float Application::GetTextWidth(std::string_view text, float scale)
+{
+    // Skip the color codes when measuring
+    return MeasureText(*s_Characters, text, scale, true).x;
+}
+
+void Application::RenderColoredText(std::string_view text, float x, float y, float scale, float alpha)
+{
+    PROFILE_ZONE("RenderColoredText");
+    LayoutColoredText(*s_Characters, text, x, y, scale, alpha,
+        [](const Character& ch, float xpos, float ypos, float w, float h, const glm::vec3& color)
+        {
+            s_Batch->SetGlyphTexture(ch.TextureID);
+            s_Batch->AddGlyph(xpos, ypos, w, h, ch.UVOrigin, ch.UVOrigin + ch.UVSize, ch.Layer, color);
+        });
+}
+
+// Windows opens a GLFW window unless asked not to, other platforms only have the headless backend
+static PlatformWindow* CreateAppWindow(int width, int height, const AppConfig& config)
+{
+#ifdef _WIN32
+    if (!config.headless)
+        return new WinWindow(width, height, "Text Glow", config.glDebug);
+#endif
+    return new HeadlessWindow(width, height, config.headlessRun, config.glDebug);
+}
+
+Application::Application(const AppConfig& config)
+    : m_Config(config)
+{
+    // Mapped first, the read ahead of the archive overlaps window creation.
+    // Without an archive everything is read from the folder of the exe.
+    s_Assets = new AssetArchive();
+    s_Assets->Open(GetExecutableDirectory() + "/assets.pak", GetExecutableDirectory(), kManifestStamp);
+
+    int width = config.width;
+    int height = config.height;
+    s_Window = CreateAppWindow(width, height, config);
+    m_Width = width;
+    m_Height = height;
+    if (!s_Window->IsOpen())
     {
-        LoadFont(ft, AssetPath("MS Reference Sans Serif Bold.ttf"), 48);
+        ShowErrorMessage("Error", "Couldn't create an OpenGL 4.5 context.");
+        m_Running = false;
+        return;
     }
-    else if( name == "extrabig" )
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    s_Projection = glm::ortho(0.0f, kViewWidth, 0.0f, kViewHeight);
+
+    // Only what the first frame needs is created here. The audio engine,
+    // shaders, fonts, icons and the glow pipeline are built on first use,
+    // or from the idle prefetch list once the first frame is on screen.
+    m_Jobs = new JobSystem();
+    m_Sounds = new SoundBank();
+    m_Cues = new CueScheduler(m_Sounds);
+    m_FrameArena = new FrameArena(kFrameArenaSize);
+    FlightRecorder::Start(config.flight);
+    if (config.checkBudgets)
     {
-        LoadFont(ft, AssetPath("bank-gothic-medium-bt.ttf"), 48);
+        RenderStats::Install();
+        for (const FrameBudget& budget : kFrameBudgets)
+            m_BudgetChecks.emplace_back(budget);
     }
-    else if( name == "objective" )
+    if (config.gpuTiming || config.gpuOverlay || !config.gpuTimingOut.empty() || config.load.runFor > 0.0 || config.renderBench.run)
     {
-        LoadFont(ft, AssetPath("Carbon-Bold.ttf"), 48);
+        m_GpuTimer = new GpuTimer();
+        m_NextGpuDump = GetAppTime() + kGpuDumpSeconds;
     }
-    else if( name == "default" )
+    if (!config.replayPath.empty())
     {
-        LoadFont(ft, AssetPath("Conduit-ITC-Std-Font.otf"), 48);
+        m_Replay = new SessionReplay();
+        if (!m_Replay->Open(config.replayPath, config.replayStep))
+        {
+            m_Running = false;
+            m_ExitCode = 1;
+        }
+        if (config.frameChecksums)
+            m_FramePixels.resize((size_t)m_Width * m_Height * 4);
     }
-    FT_Done_FreeType(ft);
+    if (config.renderBench.run)
+    {
+        m_Bench = new RenderBench(config.renderBench, m_Width, m_Height);
+        if (config.renderBench.hashes)
+            m_FramePixels.resize((size_t)m_Width * m_Height * 4);
+    }
+    decayOrder.reserve(NotifyText::kCapacity);
 
-    //std::cout << "Font type changed" << std::endl; // DEV
+    s_CookedFonts = TextureLoader::IsSupported(TexFormat::BC4);
+
+    // The array starts out transparent, icons stream in once requested
+    m_TextureLoader = new TextureLoader(m_Jobs, s_Assets);
+    m_TextureLoader->Init();
 }
 
-float Application::GetTextWidth(const std::string& text, float scale)
+// Simulation thread. The engine and the decode of every sound effect run on
+// the pool, m_AudioJob finishes when all of it is done.
+void Application::StartAudio(InitTrigger trigger)
 {
-    float width = 0.0f;
-    for (size_t i = 0; i < text.length(); ++i)
+    if (m_AudioJob.IsValid())
+        return;
+
+    double start = StartupReport::Now();
+    JobHandle engine = m_Jobs->Submit("init audio engine", [this] {
+        m_Sounds->InitEngine(m_Config.nullAudio, s_Assets);
+    });
+    std::vector<JobHandle> decodes;
+    for (int i = 0; i < (int)SoundId::Count; i++)
     {
-    	// Skip the color codes when measuring
-        if (text[i] == '^' && i + 1 < text.length()) {
-            i++; 
-            continue;
-        }
-        const Character& ch = s_Characters[text[i]];
-        width += (ch.Advance >> 6) * scale;
+        SoundId id = (SoundId)i;
+        decodes.push_back(m_Jobs->Submit((std::string("decode ") + GetAsset(id).File()).c_str(), [this, id] {
+            m_Sounds->Load(id);
+        }, { engine }));
     }
-    return width;
+    m_AudioJob = m_Jobs->Submit("audio ready", [trigger, start] {
+        s_Startup.AddInit("audio engine", trigger, start, StartupReport::Now());
+    }, decodes);
 }
 
-void Application::RenderColoredText(const std::string& text, float x, float y, float scale, float alpha)
+// Simulation thread. Blocks until the sounds can be played.
+void Application::EnsureAudio()
 {
-    glm::vec3 currentColor(1.0f);
-    s_TextShader->Bind();
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(s_VAO);
+    if (m_AudioReady)
+        return;
+    FlightMark mark("audio wait", "audio engine");
+    StartAudio(InitTrigger::FirstUse);
+    m_Jobs->Wait(m_AudioJob);
+    m_AudioReady = true;
+}
 
-    for (size_t i = 0; i < text.length(); ++i)
-    {
-    	// Color codes
-        if (text[i] == '^' && i + 1 < text.length())
-        {
-            char code = text[++i];
-            if(code == '1') currentColor = {1.0f, 0.2f, 0.2f}; // Red
-            else if(code == '2') currentColor = {0.2f, 1.0f, 0.2f}; // Green
-            else if(code == '3') currentColor = {1.0f, 1.0f, 0.0f}; // Yellow
-            else if(code == '4') currentColor = {0.0f, 0.0f, 1.0f}; // Blue
-            else if(code == '5') currentColor = {0.0f, 1.0f, 1.0f}; // Cyan
-            else if(code == '6') currentColor = {0.8f, 0.2f, 0.5f}; // pink/Magenta
-            else if(code == '7') currentColor = {1.0f, 1.0f, 1.0f}; // White
-            else if(code == '0') currentColor = {0.0f, 0.0f, 0.0f}; // Black
-            continue;
-        }
-        const Character& ch = s_Characters[text[i]];
-        if (ch.TextureID == 0) // space / empty glyph
-        {
-            x += ch.Advance * scale;
-            continue;
-        }
-        s_TextShader->SetVec3("u_Color", currentColor * alpha);
+// Render thread. Also sets kFontObjective, MeasureText runs before the first SetFont of a draw.
+void Application::EnsureTextPipeline(InitTrigger trigger)
+{
+    if (m_TextReady)
+        return;
 
-        float xpos = x + ch.Bearing.x * scale;
-        float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
-        float w = ch.Size.x * scale;
-        float h = ch.Size.y * scale;
+    double start = StartupReport::Now();
+    s_TextShader = Shader::FromSource(s_Assets->Load(GetAsset(ShaderId::TextVert)).AsText(), s_Assets->Load(GetAsset(ShaderId::TextFrag)).AsText(),
+        GetAsset(ShaderId::TextFrag).name);
+    s_TextShader->Bind();
+    s_TextShader->SetMat4("u_Projection", s_Projection);
+    s_Batch = new QuadBatch(s_TextShader, m_TextureLoader->GetIconArray());
+    SetFont(kFontObjective, trigger);
+    m_TextReady = true;
+    s_Startup.AddInit("text pipeline", trigger, start, StartupReport::Now());
+}
 
-        float vertices[6][4] = {
-            { xpos,     ypos + h,   0.0f, 0.0f },
-            { xpos,     ypos,       0.0f, 1.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
+// Render thread
+void Application::EnsureGlowPipeline(InitTrigger trigger)
+{
+    if (m_GlowReady)
+        return;
 
-            { xpos,     ypos + h,   0.0f, 0.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
-            { xpos + w, ypos + h,   1.0f, 0.0f }
-        };
+    double start = StartupReport::Now();
+    InitFBO(m_Width, m_Height);
+    InitScreenQuad();
+    s_BlurShader = Shader::FromSource(s_Assets->Load(GetAsset(ShaderId::ScreenVert)).AsText(), s_Assets->Load(GetAsset(ShaderId::BlurFrag)).AsText(),
+        GetAsset(ShaderId::BlurFrag).name);
+    s_BlurShader->Bind();
+    s_BlurShader->SetVec2("u_Resolution", { (float)m_Width, (float)m_Height });
+    m_GlowReady = true;
+    s_Startup.AddInit("glow pipeline", trigger, start, StartupReport::Now());
+}
 
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-        glNamedBufferSubData(s_VBO, 0, sizeof(vertices), vertices);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+// Simulation thread. The atlas is built on a worker and uploaded by a
+// context job, unless SetFont needed the font first. Every later call for
+// the same font returns the same upload job.
+JobHandle Application::PrefetchFont(FontId id)
+{
+    JobHandle& upload = m_FontPrefetches[(int)id];
+    if (upload.IsValid())
+        return upload;
+
+    double start = StartupReport::Now();
+    std::string file = GetAsset(id).File();
+    std::shared_ptr<TextureData> atlas = std::make_shared<TextureData>();
+    JobHandle load = m_Jobs->Submit(("load font " + file).c_str(), [atlas, id] {
+        *atlas = LoadFontAtlas(id);
+    });
+    upload = m_Jobs->Submit(("upload font " + file).c_str(), [atlas, id, file, start] {
+        if (s_FontCache[(int)id])
+            return;
+        s_FontCache[(int)id] = UploadFont(*atlas, id);
+        s_Startup.AddInit("font " + file, InitTrigger::Idle, start, StartupReport::Now());
+    }, { load }, JobAffinity::Context);
+    return upload;
+}
 
-        x += (ch.Advance >> 6) * scale;
-    }
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+// Simulation thread. Everything a notification needs is known when it is
+// enqueued, so it is made resident while the current one is still on
+// screen: the fonts, the text layout, the icon and the voice line.
+void Application::PrefetchNotify(NotifyData& data)
+{
+    m_TextureLoader->Request(data.icon, kQueuedIconPriority);
+
+    // The sound effects are decoded together with the engine
+    EnsureAudio();
+    if (!data.announcer.empty() && data.announcerStream < 0)
+        data.announcerStream = m_Sounds->PrefetchStream(AssetName(data.announcer));
+
+    // Descriptions are always in kFontDefault
+    FontId titleFont = TitleFont(data.style);
+    std::vector<JobHandle> fonts = { PrefetchFont(titleFont), PrefetchFont(kFontDefault) };
+
+    std::shared_ptr<SplashLayout> layout = std::make_shared<SplashLayout>();
+    NotifyText text = data.text;
+    NotifyDescription desc = data.description;
+    m_Jobs->Submit((std::string("layout ") + text.c_str()).c_str(), [layout, text, desc, titleFont] {
+        const std::map<char, Character>& title = GetFont(titleFont);
+        const std::map<char, Character>& body = GetFont(kFontDefault);
+        layout->titleSize = MeasureText(title, text, 1.0f, false);
+        layout->anchorSize = MeasureText(body, text, 1.0f, false);
+        layout->descWidth = MeasureText(body, desc, 1.0f, true).x;
+        layout->ready = true;
+    }, fonts, JobAffinity::Context);
+    data.layout = layout;
 }
 
-Application::Application()
+// Simulation thread, called on idle ticks. Starts the next item once the
+// previous one finished, so warming never piles up on a single frame.
+void Application::RunIdlePrefetch()
 {
-    int width = 1280;
-    int height = 720;
-    s_Window = new WinWindow(width, height, "Text Glow");
+    if (m_NextPrefetch >= std::size(s_IdlePrefetch) || !s_Startup.HasFirstFrame() || !m_Jobs->IsDone(m_PrefetchJob))
+        return;
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    PROFILE_ZONE("idle prefetch");
+    const PrefetchItem& item = s_IdlePrefetch[m_NextPrefetch++];
+    switch (item.kind)
+    {
+        case PrefetchKind::Audio:
+            StartAudio(InitTrigger::Idle);
+            m_PrefetchJob = m_AudioJob;
+            break;
+        case PrefetchKind::TextPipeline:
+            m_PrefetchJob = m_Jobs->Submit("prefetch text pipeline", [this] {
+                EnsureTextPipeline(InitTrigger::Idle);
+            }, {}, JobAffinity::Context);
+            break;
+        case PrefetchKind::GlowPipeline:
+            m_PrefetchJob = m_Jobs->Submit("prefetch glow pipeline", [this] {
+                EnsureGlowPipeline(InitTrigger::Idle);
+            }, {}, JobAffinity::Context);
+            break;
+        case PrefetchKind::Font:
+            m_PrefetchJob = PrefetchFont(item.font);
+            break;
+        case PrefetchKind::Icon:
+            m_TextureLoader->Request(item.icon);
+            break;
+    }
+}
 
-    InitFBO(width, height);
-    InitScreenQuad();
-    s_BlurShader = new Shader("shaders/screen.vert", "shaders/blur.frag");
-    s_TextShader = new Shader("shaders/text.vert", "shaders/text.frag");
+// Simulation thread, while it still owns the context. A replayed frame
+// must not depend on how far loading got, so everything a session can show
+// is made resident before the first one.
+void Application::PreloadForReplay()
+{
+    EnsureAudio();
+    EnsureTextPipeline(InitTrigger::FirstUse);
+    EnsureGlowPipeline(InitTrigger::FirstUse);
+    for (int i = 0; i < (int)FontId::Count; i++)
+        m_Jobs->Wait(PrefetchFont((FontId)i));
+    for (int i = 0; i < (int)IconId::Count; i++)
+        m_TextureLoader->Request((IconId)i);
+    m_TextureLoader->Finish();
+}
 
-    s_Projection = glm::ortho(0.0f, 1280.0f, 0.0f, 720.0f);
-    s_TextShader->Bind();
-    s_TextShader->SetMat4("u_Projection", s_Projection);
+// Render thread, after the packet's frame was presented
+void Application::AddReplayFrame(const FramePacket& packet)
+{
+    double frameMs = StartupReport::Now() - m_FrameStartMs;
+    m_Replay->AddFrame(packet.frameIndex, packet.time, frameMs, ChecksumFrame());
+}
 
-    glCreateVertexArrays(1, &s_VAO);
-    glCreateBuffers(1, &s_VBO);
-    glNamedBufferData(s_VBO, sizeof(float) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
+// Render thread. Hash of the presented frame's pixels, 0 unless they are read back.
+uint64_t Application::ChecksumFrame()
+{
+    if (m_FramePixels.empty())
+        return 0;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, s_Window->GetFramebuffer());
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, m_FramePixels.data());
+    return SessionReplay::Checksum(m_FramePixels.data(), m_FramePixels.size());
+}
 
-    glVertexArrayVertexBuffer(s_VAO, 0, s_VBO, 0, sizeof(float) * 4);
-    glEnableVertexArrayAttrib(s_VAO, 0);
-    glVertexArrayAttribFormat(s_VAO, 0, 4, GL_FLOAT, GL_FALSE, 0);
-    glVertexArrayAttribBinding(s_VAO, 0, 0);
+// Render thread, after the packet's frame was presented
+void Application::AddFlightFrame(const FramePacket& packet)
+{
+    if (!FlightRecorder::IsRecording())
+        return;
 
-    ma_engine_init(NULL, &engine);
+    FlightFrame frame;
+    frame.index = packet.frameIndex;
+    frame.presentMs = StartupReport::Now();
+    frame.intervalMs = m_LastPresentMs > 0.0 ? (float)(frame.presentMs - m_LastPresentMs) : 0.0f;
+    frame.renderMs = (float)(frame.presentMs - m_FrameStartMs);
+    frame.simMs = packet.simMs;
+    frame.scenario = kFrameBudgets[(int)GetScenario(packet)].scenario;
+    m_LastPresentMs = frame.presentMs;
+
+    if (m_GpuTimer && packet.frameIndex >= GpuTimer::kFramesInFlight)
+        FlightRecorder::AddGpuTime(packet.frameIndex - GpuTimer::kFramesInFlight, m_GpuTimer->GetCollectedFrameMs());
+    if (FlightRecorder::AddFrame(frame))
+    {
+        AllocPause pause;
+        m_Jobs->Submit("write hitch snapshot", [] {
+            FlightRecorder::WriteSnapshot();
+        });
+    }
+}
 
-    // ===== FreeType =====
-    SetFont("objective");
+std::vector<RenderBench::SceneResult> Application::GetBenchResults() const
+{
+    return m_Bench ? m_Bench->GetResults() : std::vector<RenderBench::SceneResult>();
 }
 
 Application::~Application()
 {
-    ma_engine_uninit(&engine);
+    delete m_Recorder;
+    delete m_Replay;
+    delete m_Load;
+    delete m_Bench;
+
+    // The font cache and the pulse outlive the context they belong to, the
+    // next Application (one per --render-bench resolution) starts over
+    for (std::optional<std::map<char, Character>>& font : s_FontCache)
+        font.reset();
+    s_Characters = nullptr;
+    curFontType = FontId::Count;
+    g_PulseTextFX = PulseTextFX();
+
+    // The window never opened, nothing else was created
+    if (!m_Jobs)
+    {
+        delete s_Assets;
+        delete s_Window;
+        return;
+    }
+
+    delete m_RenderThread;
+    m_Jobs->WaitAll();
+    delete s_Batch;
+    delete m_TextureLoader;
+    m_Jobs->PrintTimeline(std::cout);
+    delete m_Jobs;
+    s_Startup.PrintReport(std::cout);
+    FlightRecorder::PrintReport(std::cout);
+    m_Cues->PrintReport(std::cout);
+    m_Sounds->PrintReport(std::cout);
+    std::cout << "[Arena] peak " << m_FrameArena->GetPeak() << " of " << m_FrameArena->GetCapacity() << " bytes" << std::endl;
+    delete m_FrameArena;
+    delete m_Cues;
+    delete m_Sounds;
+    delete s_Assets;
+    if (m_GpuTimer)
+    {
+        WriteGpuTimings();
+        m_GpuTimer->PrintReport(std::cout);
+        delete m_GpuTimer;
+    }
+    GLDebug::PrintReport(std::cout);
     delete s_TextShader;
     delete s_BlurShader;
     glDeleteFramebuffers(1, &m_FBO);
@@ -386,43 +718,33 @@ Application::~Application()
     delete s_Window;
 }
 
-void Application::StartPulseText(PulseTextFX& fx, const std::string& text)
+void Application::StartPulseText(PulseTextFX& fx, std::string_view text)
 {
     fx.text = text;
-    fx.birthTime = (float)glfwGetTime();
+    fx.birthTime = (float)GetAppTime();
     fx.letterDelay = 0.08f;
     fx.holdTime = 2.0f;
     fx.decayDuration = 1.0f;
     fx.pulseSpeed = 6.0f;
     fx.active = true;
+    FlightRecorder::Mark("pulse text", fx.text, StartupReport::Now());
 
-    float decayStepTime = 0.12f; // 0.12f = MW2 ~100–150ms
-    int   decayBatchMin = 2;
-    int   decayBatchMax = 3;
-
-    decayOrder.clear();
+    std::span<int> indices = m_FrameArena->AllocArray<int>(fx.text.size());
+    BuildDecayOrder(indices, (uint32_t)(fx.birthTime * 1000), decayOrder);
 
-    std::vector<int> indices(fx.text.size());
-    std::iota(indices.begin(), indices.end(), 0);
-    std::mt19937 rng((uint32_t)(fx.birthTime * 1000));
-    std::shuffle(indices.begin(), indices.end(), rng);
-
-    float t = 0.0f;
-    size_t i = 0;
-
-    while (i < indices.size())
+    // One blip per typed letter (not for spaces), the delete sound when the decay starts
+    EnsureAudio();
+    std::span<AudioCue> cues = m_FrameArena->AllocArray<AudioCue>(fx.text.size() + 1);
+    size_t cueCount = 0;
+    for (size_t letter = 0; letter < fx.text.size(); letter++)
     {
-        int batch = rng() % (decayBatchMax - decayBatchMin + 1) + decayBatchMin;
-    
-        for (int b = 0; b < batch && i < indices.size(); b++, i++)
-        {
-            decayOrder.push_back({
-                indices[i],
-                t + ((rng() % 30) / 1000.0f) // 0–30ms jitter
-            });
-        }
-        t += decayStepTime;
+        if (fx.text[letter] != ' ')
+            cues[cueCount++] = { SoundId::UiComputerTextBlip1x, letter * fx.letterDelay };
     }
+    cues[cueCount++] = { SoundId::UiComputerTextDelete1, (fx.text.size() * fx.letterDelay) + fx.holdTime };
+
+    m_Cues->Cancel(m_PulseCues);
+    m_PulseCues = m_Cues->Begin(cues.first(cueCount), fx.birthTime);
 }
 
 char Application::GetStableRandomChar(int index, int seed)
@@ -432,36 +754,40 @@ char Application::GetStableRandomChar(int index, int seed)
     return 'A' + (s % 26);
 }
 
-void Application::DrawPulseTextLayers(PulseTextFX& fx, float baseX, float baseY, bool isFboPass, bool endFX)
+void Application::UpdatePulseText(PulseTextFX& fx, double now)
+{
+    // The blips and the delete sound are scheduled as cues in StartPulseText()
+    float elapsed = (float)now - fx.birthTime;
+    float decayStart = (fx.text.size() * fx.letterDelay) + fx.holdTime;
+
+    if (elapsed > decayStart + fx.decayDuration)
+        fx.active = false;
+}
+
+// How far the pen moves past c, nothing for chars the atlas doesn't have
+static float GetGlyphAdvance(char c, float scale)
+{
+    auto it = s_Characters->find(c);
+    if (it == s_Characters->end())
+        return 0.0f;
+    const Character& ch = it->second;
+    if (ch.TextureID == 0) // space / empty glyph
+        return ch.Advance * scale;
+    return (ch.Advance >> 6) * scale;
+}
+
+void Application::DrawPulseTextLayers(const FramePacket& packet, float baseX, float baseY)
 {
-    float elapsed = (float)glfwGetTime() - fx.birthTime;
+    const PulseTextFX& fx = packet.pulseText;
+    float elapsed = (float)packet.time - fx.birthTime;
     float textScale = 1.0f;
-    glm::vec2 totalSize = MeasureText(fx.text, textScale);
+    glm::vec2 totalSize = MeasureText(*s_Characters, fx.text, textScale, false);
     float correctedBaseY = baseY - (totalSize.y * 0.5f);
     float x = baseX;
     float flickerSpeed = 40.0f;
     int currentLeadIndex = (int)(elapsed / fx.letterDelay);
     float decayStart = (fx.text.size() * fx.letterDelay) + fx.holdTime;
 
-    if (currentLeadIndex > fx.lastPlayedIndex && currentLeadIndex < (int)fx.text.size())
-    {
-    	// Don't make a sound when using a space.
-        if (fx.text[currentLeadIndex] != ' ')
-        {
-            ma_engine_play_sound(&engine, AssetPath("ui_computer_text_blip1x.wav").c_str(), NULL);
-        }
-
-        // Updating that this index has already been "handled"
-        fx.lastPlayedIndex = currentLeadIndex;
-    }
-    if (elapsed >= decayStart && !fx.playedDecaySound)
-    {
-        ma_engine_play_sound(&engine, AssetPath("ui_computer_text_delete1.wav").c_str(), NULL);
-        fx.playedDecaySound = true; // Mark it as done, it won't play again in this cycle
-    }
-
-    s_TextShader->Bind();
-
     for (size_t i = 0; i < fx.text.size(); i++)
     {
         float appearTime = i * fx.letterDelay;
@@ -474,7 +800,7 @@ void Application::DrawPulseTextLayers(PulseTextFX& fx, float baseX, float baseY,
         bool decaying = elapsed > decayStart;
 
         if (!decaying) {
-            if (i == currentLeadIndex) {
+            if ((int)i == currentLeadIndex) {
                 alpha = std::min((elapsed - appearTime) / fx.letterDelay, 1.0f);
                 drawChar = GetStableRandomChar((int)i, (int)(elapsed * flickerSpeed) + (int)i);
             }
@@ -486,34 +812,24 @@ void Application::DrawPulseTextLayers(PulseTextFX& fx, float baseX, float baseY,
         else
         {
             float totalDecayTime = elapsed - decayStart;
-            float progress = totalDecayTime / fx.decayDuration;
             bool isRemoved = false;
             bool isDecayingNow = false;
             float localT;
             int flickerSeed = (int)(elapsed * flickerSpeed) + (int)i + 789;
 
-            for (const auto& d : decayOrder)
+            if (const DecayEntry* d = FindDecayEntry(packet.decayOrder, (int)i))
             {
-                if (d.index == (int)i)
-                {
-                    localT = totalDecayTime - d.startTime;
-            
-                    if (localT >= fx.decayDuration * 0.3f)
-                        isRemoved = true;
-                    else if (localT > 0.0f)
-                        isDecayingNow = true;
-                    break;
-                }
+                localT = totalDecayTime - d->startTime;
+
+                if (localT >= fx.decayDuration * 0.3f)
+                    isRemoved = true;
+                else if (localT > 0.0f)
+                    isDecayingNow = true;
             }
 
             if (isRemoved)
             {
-                if (s_Characters[fx.text[i]].TextureID == 0) // space / empty glyph
-                {
-                    x += s_Characters[fx.text[i]].Advance * textScale;
-                    continue;
-                }
-                x += (s_Characters[fx.text[i]].Advance >> 6) * textScale;
+                x += GetGlyphAdvance(fx.text[i], textScale);
                 continue;
             }
 
@@ -532,435 +848,695 @@ void Application::DrawPulseTextLayers(PulseTextFX& fx, float baseX, float baseY,
 
         //float pulse = sin(localT * fx.pulseSpeed) * 5.0f;
 
-        s_TextShader->SetVec3("u_Color", glm::vec3(1.0f) * alpha);
-
-        std::string s(1, drawChar);
-        RenderText(s_TextShader, s, x, correctedBaseY /*+ pulse*/, textScale, TextAlignX::Left, TextAlignY::Bottom);
+        RenderText(std::string_view(&drawChar, 1), x, correctedBaseY /*+ pulse*/, textScale, TextAlignX::Left, TextAlignY::Bottom, glm::vec3(1.0f) * alpha);
 
-        if (s_Characters[fx.text[i]].TextureID == 0) // space / empty glyph
-        {
-            x += s_Characters[fx.text[i]].Advance * textScale;
-            continue;
-        }
-
-        x += (s_Characters[fx.text[i]].Advance >> 6) * textScale;
-    }
-    if( endFX )
-    {
-        if (elapsed > decayStart + fx.decayDuration)
-            fx.active = false;
+        x += GetGlyphAdvance(fx.text[i], textScale);
     }
 }
 
-void Application::RenderPulseText(PulseTextFX& fx, float baseX, float baseY)
+void Application::RenderPulseText(const FramePacket& packet, float baseX, float baseY)
 {
-    if (!fx.active) return;
-    SetFont("objective");
+    SetFont(kFontObjective);
 
     // 1. DRAWING ON FBO (FOR GLOW)
-    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
-    glViewport(0, 0, m_Width, m_Height);
-    glClearColor(0.0f, 0.0f, 0.0f, 0.0f); 
-    glClear(GL_COLOR_BUFFER_BIT); // Only delete once at the beginning of the FBO!
-
-    // First, draw all visible characters on the FBO
-    DrawPulseTextLayers(fx, baseX, baseY, true, false);
+    {
+        GpuPass pass(m_GpuTimer, "pulsefx mask");
+        glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+        glViewport(0, 0, m_Width, m_Height);
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f); 
+        glClear(GL_COLOR_BUFFER_BIT); // Only delete once at the beginning of the FBO!
+
+        // First, draw all visible characters on the FBO
+        DrawPulseTextLayers(packet, baseX, baseY);
+        s_Batch->Flush();
+    }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, s_Window->GetFramebuffer());
 
     // 2. SCREEN CLEARANCE AND GLOW DRAWING
-    glViewport(0, 0, m_Width, m_Height);
-    glClearColor(0.05f, 0.05f, 0.08f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+    {
+        GpuPass pass(m_GpuTimer, "pulsefx glow");
+        glViewport(0, 0, m_Width, m_Height);
+        glClearColor(0.05f, 0.05f, 0.08f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
 
-    // Additive blending for shine
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        // Additive blending for shine
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE);
 
-    s_BlurShader->Bind();
-    s_BlurShader->SetVec3("u_GlowColor", { 0.25f, 0.75f, 0.25f });
-    s_BlurShader->SetFloat("u_BlurRadius", 6.0f);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_FBOTexture);
-    RenderScreenQuad();
+        s_BlurShader->Bind();
+        s_BlurShader->SetVec3("u_GlowColor", { 0.25f, 0.75f, 0.25f });
+        s_BlurShader->SetFloat("u_BlurRadius", 6.0f);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, m_FBOTexture);
+        RenderScreenQuad();
+    }
 
     // 3. DRAWING SHARP TEXT
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    DrawPulseTextLayers(fx, baseX, baseY, false, true);
+    {
+        GpuPass pass(m_GpuTimer, "pulsefx text");
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        DrawPulseTextLayers(packet, baseX, baseY);
+        s_Batch->Flush();
+    }
 }
 
-GLuint LoadTexture(const char* path)
+void Application::RenderIcon(IconId icon, float x, float y, float w, float h, float alpha)
 {
-    GLuint textureID;
-    glGenTextures(1, &textureID);
+    // Goes into the same batch as the text, a layer that is still streaming in is transparent
+    s_Batch->AddIcon(x, y, w, h, (int)icon, glm::vec3(1.0f) * alpha);
+}
 
-    int width, height, nrComponents;
-    stbi_set_flip_vertically_on_load(true); 
-    unsigned char* data = stbi_load(path, &width, &height, &nrComponents, 0);
+void Application::StartNotify(NotifyData&& data)
+{
+    m_DoingNotify = true;
+    m_Current = std::move(data);
 
-    if (data)
-    {
-        GLenum format;
-        if (nrComponents == 1) format = GL_RED;
-        else if (nrComponents == 3) format = GL_RGB;
-        else if (nrComponents == 4) format = GL_RGBA;
+    m_Splash.Start();
+    m_NotifyState = NotifyState::Splash;
+    FlightRecorder::Mark("notify start", m_Current.text, StartupReport::Now());
 
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+    EnsureAudio();
+    m_Cues->Cancel(m_SplashCues);
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // Both stream voices may have been taken when this one was enqueued,
+    // the voice line gets another try now that it is about to play
+    if (!m_Current.announcer.empty() && m_Current.announcerStream < 0)
+    {
+        AllocPause pause;
+        m_Current.announcerStream = m_Sounds->PrefetchStream(AssetName(m_Current.announcer));
+    }
 
-        stbi_image_free(data);
+    std::span<AudioCue> cues = m_FrameArena->AllocArray<AudioCue>(m_Current.cues.size() + 1);
+    std::copy(m_Current.cues.begin(), m_Current.cues.end(), cues.begin());
+    size_t cueCount = m_Current.cues.size();
+    if (m_Current.announcerStream >= 0)
+    {
+        AudioCue& line = cues[cueCount++];
+        line.offset = kAnnouncerOffset;
+        line.stream = m_Current.announcerStream;
     }
-    else
+
+    m_SplashCues = m_Cues->Begin(cues.first(cueCount), m_Splash.startTime);
+}
+
+void Application::NotifyMessage(NotifyData&& data)
+{
+    // Enqueueing loads and submits jobs, only the frames after it have to get by without the heap
+    AllocPause pause;
+    s_Startup.MarkNotifyRequested();
+    data.id = ++m_NextNotifyId;
+    FlightRecorder::Mark("notify", data.text, StartupReport::Now());
+    if (m_Recorder)
+        m_Recorder->RecordNotify(GetAppTime(), data);
+    if (m_Load)
+        m_Load->OnEnqueued(data.id, std::holds_alternative<KillstreakStyle>(data.style) ? LoadKind::Killstreak : LoadKind::Splash, GetAppTime());
+
+    // Checked before prefetching, a dropped notification would hold one of the few stream voices
+    bool startNow = !m_DoingNotify || m_Splash.IsFinished();
+    if (!startNow && m_NotifyQueue.IsFull())
     {
-        std::cout << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
+        if (m_Load)
+            m_Load->CountDropped();
+        else
+            std::cerr << "[Notify] Queue is full (" << kMaxQueuedNotifies << "), dropped: " << data.text.c_str() << std::endl;
+        return;
     }
 
-    return textureID;
+    PrefetchNotify(data);
+    if (startNow)
+        StartNotify(std::move(data));
+    else
+        m_NotifyQueue.Push(std::move(data));
 }
 
-void Application::RenderIcon(GLuint textureID, float x, float y, float w, float h, float alpha)
+void Application::SplashNotify(const SplashDrawData& data)
 {
-    s_TextShader->Bind();
-    s_TextShader->SetInt("u_IsIcon", 1); // Turn on icon mode
-    s_TextShader->SetVec3("u_Color", glm::vec3(1.0f) * (float)alpha);
+    PROFILE_ZONE("SplashNotify");
+    std::visit([this, &data](auto style) { DrawSplash<decltype(style)>(data); }, data.style);
+}
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+template <typename Style>
+void Application::DrawSplash(const SplashDrawData& data)
+{
+    std::string_view text = data.text;
+    std::string_view desc = data.description;
+    IconId icon = data.icon;
+    float textScale = data.textScale;
+    double scale = data.scale;
+    double alpha = data.alpha;
+    const glm::vec3& color = data.color;
 
-    float vertices[6][4] = {
-        { x,     y + h,   0.0f, 1.0f },
-        { x,     y,       0.0f, 0.0f },
-        { x + w, y,       1.0f, 0.0f },
+    float centerX = kViewWidth * 0.5f;
+    float centerY = kViewHeight * 0.5f;
 
-        { x,     y + h,   0.0f, 1.0f },
-        { x + w, y,       1.0f, 0.0f },
-        { x + w, y + h,   1.0f, 1.0f }
-    };
+    // The queue measured the text in advance, the fallback measures it the way it always did
+    const SplashLayout* layout = data.layout && data.layout->ready ? data.layout.get() : nullptr;
+    glm::vec2 mainSize = layout ? layout->anchorSize * textScale : MeasureText(*s_Characters, text, textScale, false);
 
-    glBindVertexArray(s_VAO); // Use existing VAO
-    glBindBuffer(GL_ARRAY_BUFFER, s_VBO);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+    float iconSize = 0.0f;
+    if (icon != IconId::None)
+        iconSize = 140.0f * textScale * (float)scale;
 
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    SetFont(Style::kTitleFont);
+    SplashGeometry geometry = Style::Layout({ { centerX, centerY }, mainSize, iconSize, textScale, (float)scale, (float)alpha, (float)data.x });
+    float xOffset = geometry.xOffset;
+    float textY = geometry.textY;
+    textScale = geometry.textScale;
 
-    s_TextShader->SetInt("u_IsIcon", 0); // Reset to text mode
-}
+    float iconX = 0.0f;
+    if (icon != IconId::None)
+        iconX = (centerX + xOffset) - (iconSize * 0.5f);
 
-void Application::StartNotify(const NotifyData& data)
-{
-    m_DoingNotify = true;
-    m_SplashText  = data.text;
-    m_SplashDesc = data.description;
-    m_SplashIcon = data.icon;
-    m_SplashColor = data.color;
-    m_SplashType = data.type;
+    // -- 1. Rendering the "Mask" into FBO --
+    glm::vec2 titleSize = layout ? layout->titleSize * textScale : MeasureText(*s_Characters, text, textScale, false);
+    {
+        GpuPass pass(m_GpuTimer, "splash mask");
+        glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+        glViewport(0, 0, m_Width, m_Height);
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
 
-    m_Splash.Start();
-    m_NotifyState = NotifyState::Splash;
-}
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); 
 
-void Application::NotifyMessage(const NotifyData& data)
-{
-    if (!m_DoingNotify || m_Splash.IsFinished())
+        RenderText(text, titleSize, centerX + xOffset, textY, (float)textScale, TextAlignX::Center, TextAlignY::Center, glm::vec3(1.0f));
+        s_Batch->Flush();
+    }
+
+    // -- 2. Rendering Glow to the screen (from the FBO texture) --
+    // The blur shader samples the mask and composites in the same draw
     {
-        StartNotify(data);
-        return;
+        GpuPass pass(m_GpuTimer, "splash glow");
+        glBindFramebuffer(GL_FRAMEBUFFER, s_Window->GetFramebuffer());
+        glViewport(0, 0, m_Width, m_Height);
+        glClearColor(0.05f, 0.05f, 0.08f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+
+        s_BlurShader->Bind();
+        s_BlurShader->SetVec2("u_Resolution", { (float)m_Width, (float)m_Height });
+
+        glm::vec3 glowColor = color * (float)alpha;
+        s_BlurShader->SetVec3("u_GlowColor", glowColor);
+        s_BlurShader->SetFloat("u_BlurRadius", Style::kGlowRadius * (float)alpha);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, m_FBOTexture);
+        s_BlurShader->SetInt("u_ScreenTexture", 0);
+
+        RenderScreenQuad();
+    }
+
+    // -- 3. Drawing the sharp text on top of the glow --
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    {
+        GpuPass pass(m_GpuTimer, "splash title");
+        RenderText(text, titleSize, centerX + xOffset, textY, (float)textScale, TextAlignX::Center, TextAlignY::Center, glm::vec3(1.0f) * (float)alpha);
+    }
+
+    if (icon != IconId::None)
+    {
+        GpuPass pass(m_GpuTimer, "splash icon");
+        RenderIcon(icon, iconX + 7.0f, geometry.iconDrawY, iconSize, iconSize, (float)alpha);
     }
-    m_NotifyQueue.push_back(data);
-}
 
-int soundIter = 0;
-void Application::playNotifySound(const char* pFilePath)
-{
-    if( soundIter == 2 && m_Splash.phase == SplashPhase::In )
     {
-        ma_engine_play_sound(&engine, pFilePath, NULL);
+        GpuPass pass(m_GpuTimer, "splash description");
+        SetFont(kFontDefault);
+        float totalWidth = layout ? layout->descWidth * geometry.descScale : GetTextWidth(desc, geometry.descScale);
+        float startX = (centerX + xOffset) - (totalWidth * 0.5f);
+        RenderColoredText(desc, startX, geometry.descY, geometry.descScale, (float)alpha);
+        s_Batch->Flush();
     }
-    soundIter++;
 }
 
-void Application::SplashNotify(const std::string& text, const std::string& desc, GLuint icon, float textScale, double scale, double alpha, double x, const glm::vec3& color)
+void Application::glowPulse(std::string_view text, float textScale, double time)
 {
-    float centerX = m_Width * 0.5f;
-    float centerY = m_Height * 0.5f;
-    float yOffset;
-    float xOffset = 0.0f;
-    float descScale = 0.0f;
-    float startYOffset = 260.0f;
-    float endYOffset = 180.0f;
-    float t = glm::clamp((float)alpha, 0.0f, 1.0f);
-    float descY = 0.0f;
-    float iconY = 0.0f;
-    glm::vec2 mainSize = MeasureText(text, textScale);
-    float textCenterY = centerY + endYOffset;
-    float iconCenterY = textCenterY + mainSize.y * 3.3f;
-    float descCenterY = textCenterY - mainSize.y * 2.5f;
-
-    float startY = centerY + startYOffset;
-
-    float iconDrawY = 0.0f;
-    float iconSize = 0.0f;
-    float iconX = 0.0f;
+    SetFont(kFontExtraBig);
 
-    float textY = 0.0f;
+    {
+        GpuPass pass(m_GpuTimer, "glow pulse mask");
+        glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+        glViewport(0, 0, m_Width, m_Height);
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
 
-    if (icon != 0)
-        iconSize = 140.0f * textScale * (float)scale;
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    if( m_SplashType == "killstreak" )
-    {
-        SetFont("extrabig");
-        yOffset = 180.0f;
-        float spacing = mainSize.y * 2.7f;
-        descY = (centerY + yOffset) - spacing;
-        xOffset = (float)x;
-        textY = centerY + yOffset;
-        iconY = (centerY + yOffset) + 20.0f;
-        iconDrawY = iconY;
-        descScale = 0.375f * (float)scale;
-        playNotifySound( AssetPath("mp_killstrk_radar.wav").c_str() );
+        RenderText(text, 400, 360, textScale, TextAlignX::Center, TextAlignY::Center, { 1.0f, 1.0f, 1.0f });
+        s_Batch->Flush();
     }
-    else if( m_SplashType == "splash" )
+
     {
-        SetFont("bold");
-        descY = glm::mix(startY, descCenterY, t);
-        yOffset = glm::mix(startYOffset, endYOffset, t);
-        textY = glm::mix(startY, textCenterY, t);
-        iconY = glm::mix(startY, iconCenterY, t);
-        iconDrawY = iconY - iconSize * 0.5f;
-        textScale = textScale * (float)scale;
-        descScale = 0.375f * (float)scale;
-        playNotifySound( AssetPath("mp_last_stand.wav").c_str() );
-    }
+        GpuPass pass(m_GpuTimer, "glow pulse glow");
+        glBindFramebuffer(GL_FRAMEBUFFER, s_Window->GetFramebuffer());
+        glViewport(0, 0, m_Width, m_Height);
+        glClearColor(0.05f, 0.05f, 0.08f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
 
-    if (icon != 0)
-        iconX = (centerX + xOffset) - (iconSize * 0.5f);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE);
 
-    // -- 1. Rendering the "Mask" into FBO --
-    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
-    glViewport(0, 0, m_Width, m_Height);
-    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+        s_BlurShader->Bind();
+        s_BlurShader->SetVec2("u_Resolution", { (float)m_Width, (float)m_Height });
+        s_BlurShader->SetVec3("u_GlowColor", { 0.25f, 0.75f, 0.25f });
+        float pulse = 4.0f + sin((float)time * 3.0f) * 1.5f;
+        s_BlurShader->SetFloat("u_BlurRadius", pulse);
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); 
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, m_FBOTexture);
+        s_BlurShader->SetInt("u_ScreenTexture", 0);
 
-    s_TextShader->Bind();
-    s_TextShader->SetVec3("u_Color", glm::vec3(1.0f));
-    RenderText(s_TextShader, text, centerX + xOffset, textY, (float)textScale, TextAlignX::Center, TextAlignY::Center, 0.0f);
+        RenderScreenQuad();
+    }
 
-    // -- 2. Rendering Glow to the screen (from the FBO texture) --
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glViewport(0, 0, m_Width, m_Height);
-    glClearColor(0.05f, 0.05f, 0.08f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+    {
+        GpuPass pass(m_GpuTimer, "glow pulse text");
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        RenderText(text, 400, 360, textScale, TextAlignX::Center, TextAlignY::Center, { 1.0f, 1.0f, 1.0f });
+        s_Batch->Flush();
+    }
+}
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+void Application::RenderFrame(const FramePacket& packet)
+{
+    PROFILE_ZONE("RenderFrame");
+    AllocTracker::TrackThisThread();
+    if (m_GpuTimer)
+        m_GpuTimer->BeginFrame();
+    {
+        // Loading may allocate, drawing the frame may not
+        AllocPause pause;
 
-    s_BlurShader->Bind();
-    s_BlurShader->SetVec2("u_Resolution", { (float)m_Width, (float)m_Height });
+        // GL uploads queued by the job system land here
+        m_Jobs->SetContextThread(std::this_thread::get_id());
+        m_Jobs->RunContextJobs();
+        m_TextureLoader->Update();
 
-    glm::vec3 glowColor = color * (float)alpha;
-    s_BlurShader->SetVec3("u_GlowColor", glowColor);
-    s_BlurShader->SetFloat("u_BlurRadius", 5.0f * (float)alpha);
+        // Whatever the idle prefetch hasn't warmed yet is built right before its first draw
+        if (packet.drawSplash || packet.drawPulseText || packet.state == NotifyState::Pulse)
+        {
+            EnsureTextPipeline(InitTrigger::FirstUse);
+            EnsureGlowPipeline(InitTrigger::FirstUse);
+        }
+    }
+    if (RenderStats::IsInstalled())
+        RenderStats::BeginFrame();
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_FBOTexture);
-    s_BlurShader->SetInt("u_ScreenTexture", 0);
+    glClearColor(0.05f, 0.05f, 0.08f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
 
-    RenderScreenQuad();
+    if( packet.drawPulseText )
+        RenderPulseText(packet, 360.0f, 540.0f);
 
-    // -- 3. Drawing the sharp text on top of the glow --
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    s_TextShader->Bind();
-    s_TextShader->SetVec3("u_Color", glm::vec3(1.0f) * (float)alpha);
-    RenderText(s_TextShader, text, centerX + xOffset, textY, (float)textScale, TextAlignX::Center, TextAlignY::Center, 0.0f);
+    switch (packet.state)
+    {
+        case NotifyState::Splash:
+            if( packet.drawSplash )
+                SplashNotify(packet.splash);
+            break;
+        case NotifyState::Pulse:
+            glowPulse(packet.glowText, 1.0f, packet.time);
+            break;
+        default:
+            break;
+    }
 
+    if (!m_BudgetChecks.empty())
+        m_BudgetChecks[(int)GetScenario(packet)].Add(RenderStats::EndFrame(), packet.frameIndex);
 
-    if (icon != 0)
-    {RenderIcon(icon, iconX + 7.0f, iconDrawY, iconSize, iconSize, (float)alpha);}
+    if (m_GpuTimer)
+    {
+        if (m_Config.gpuOverlay)
+            DrawGpuOverlay();
+        m_GpuTimer->EndFrame();
 
+        if (!m_Config.gpuTimingOut.empty() && GetAppTime() >= m_NextGpuDump)
+        {
+            AllocPause pause;
+            WriteGpuTimings();
+            m_NextGpuDump += kGpuDumpSeconds;
+        }
+    }
 
-    SetFont("default");
-    float totalWidth = GetTextWidth(desc, descScale);
-    float startX = (centerX + xOffset) - (totalWidth * 0.5f);
-    RenderColoredText(desc, startX, descY, descScale, (float)alpha);
+    // The visuals of these cues are in this frame, compare with when their audio started
+    for (const CueMarker& marker : packet.cueMarkers)
+        m_Cues->RecordSkew(GetAppTime() - marker.audioTime);
+    GL_CHECK("RenderFrame");
 }
 
-void Application::glowPulse(const std::string& text, float textScale)
+// Render thread. Min / avg / p99 of every pass in the top left corner,
+// drawn before the frame's timing ends so it shows up as a pass too.
+void Application::DrawGpuOverlay()
 {
-    SetFont("extrabig");
+    // Not worth building the text pipeline for, it shows up with the first notification or the idle prefetch
+    if (!m_TextReady)
+        return;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
-    glViewport(0, 0, m_Width, m_Height);
-    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+    GpuPass pass(m_GpuTimer, "overlay");
+    GpuPassStats stats[GpuTimer::kMaxPasses];
+    size_t count = m_GpuTimer->GetStats(stats);
 
+    SetFont(kFontDefault);
+    glBindFramebuffer(GL_FRAMEBUFFER, s_Window->GetFramebuffer());
+    glViewport(0, 0, m_Width, m_Height);
+    glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    s_TextShader->Bind();
-    s_TextShader->SetVec3("u_Color", {1.0f, 1.0f, 1.0f});
-    RenderText(s_TextShader, text, 400, 360, textScale, TextAlignX::Center, TextAlignY::Center, 0.0f);
+    const float kScale = 0.3f;
+    const float kLine = 18.0f;
+    const float kColumns[] = { 260.0f, 330.0f, 400.0f };
+    const glm::vec3 kHeaderColor = { 1.0f, 0.85f, 0.3f };
+    const glm::vec3 kRowColor = { 0.9f, 0.9f, 0.9f };
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glViewport(0, 0, m_Width, m_Height);
-    glClearColor(0.05f, 0.05f, 0.08f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+    float y = kViewHeight - 24.0f;
+    RenderText("GPU ms", 12.0f, y, kScale, TextAlignX::Left, TextAlignY::Bottom, kHeaderColor);
+    RenderText("min", kColumns[0], y, kScale, TextAlignX::Right, TextAlignY::Bottom, kHeaderColor);
+    RenderText("avg", kColumns[1], y, kScale, TextAlignX::Right, TextAlignY::Bottom, kHeaderColor);
+    RenderText("p99", kColumns[2], y, kScale, TextAlignX::Right, TextAlignY::Bottom, kHeaderColor);
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    char number[16];
+    for (size_t i = 0; i < count; i++)
+    {
+        y -= kLine;
+        RenderText(stats[i].name, 12.0f, y, kScale, TextAlignX::Left, TextAlignY::Bottom, kRowColor);
+        const float values[] = { stats[i].minMs, stats[i].avgMs, stats[i].p99Ms };
+        for (int column = 0; column < 3; column++)
+        {
+            snprintf(number, sizeof(number), "%.3f", values[column]);
+            RenderText(number, kColumns[column], y, kScale, TextAlignX::Right, TextAlignY::Bottom, kRowColor);
+        }
+    }
+    s_Batch->Flush();
+}
 
-    s_BlurShader->Bind();
-    s_BlurShader->SetVec2("u_Resolution", { (float)m_Width, (float)m_Height });
-    s_BlurShader->SetVec3("u_GlowColor", { 0.25f, 0.75f, 0.25f });
-    float pulse = 4.0f + sin((float)glfwGetTime() * 3.0f) * 1.5f;
-    s_BlurShader->SetFloat("u_BlurRadius", pulse);
+// Render thread, or the main thread once it is stopped. A .json file holds
+// the latest window, anything else gets CSV rows appended per dump.
+void Application::WriteGpuTimings()
+{
+    const std::string& path = m_Config.gpuTimingOut;
+    if (path.empty())
+        return;
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_FBOTexture);
-    s_BlurShader->SetInt("u_ScreenTexture", 0);
+    bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    std::ofstream out(path, json || !m_GpuDumpStarted ? std::ios::trunc : std::ios::app);
+    if (!out)
+    {
+        std::cerr << "[GpuTime] Couldn't write " << path << std::endl;
+        return;
+    }
 
-    RenderScreenQuad();
+    if (json)
+        m_GpuTimer->WriteJson(out, GetAppTime());
+    else
+        m_GpuTimer->WriteCsv(out, GetAppTime(), !m_GpuDumpStarted);
+    m_GpuDumpStarted = true;
+}
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    s_TextShader->Bind();
-    s_TextShader->SetVec3("u_Color", { 1.0f, 1.0f, 1.0f });
-    RenderText(s_TextShader, text, 400, 360, textScale, TextAlignX::Center, TextAlignY::Center, 0.0f);
+static const char* FindMissingAsset(const AssetRef* assets, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (!s_Assets->Contains(assets[i]))
+            return assets[i].name;
+    }
+    return nullptr;
+}
+
+// The first asset of the manifest that can't be loaded, null when all are there
+static const char* FindMissingAsset()
+{
+    const char* missing[] = {
+        FindMissingAsset(kFontAssets, (int)FontId::Count),
+        FindMissingAsset(kIconAssets, (int)IconId::Count),
+        FindMissingAsset(kSoundAssets, (int)SoundId::Count),
+        FindMissingAsset(kShaderAssets, (int)ShaderId::Count),
+    };
+    for (const char* name : missing)
+    {
+        if (name)
+            return name;
+    }
+    return nullptr;
 }
-PulseTextFX g_PulseTextFX;
 
 void Application::Run()
 {
-    std::filesystem::path p = g_AssetRoot;
-    bool filepathExists = std::filesystem::is_directory(p.parent_path());
-    if( !filepathExists )
+    if (!m_Running)
+        return;
+
+    // Assets the code refers to can't go missing at build time anymore, the
+    // manifest only has ids for files that were packed. This catches an exe
+    // that was copied without its archive (or its loose folders).
+    const char* missing = FindMissingAsset();
+    if( missing )
     {
-        MessageBoxA(
-            nullptr,
-            "The assets folder is missing!\n\n"
-            "Check if the 'assets' directory exists next to the exe.",
-            "Error",
-            MB_ICONERROR | MB_OK
-        );
+        std::string message = std::string("An asset is missing: ") + missing + "\n\n"
+            "Check if assets.pak (or the 'assets' and 'shaders' directories) exists next to the exe.";
+        ShowErrorMessage("Error", message);
         return;
     }
-    const std::string& text = "Eliminate enemy players.";
+    std::string_view text = "Eliminate enemy players.";
     float textScale = 1.0f;
     bool pulseActive = false;
+    uint64_t frameIndex = 0;
+
+    if (m_Replay || m_Bench)
+        PreloadForReplay();
+
+    // From here on the GL context belongs to the render thread
+    m_Jobs->SetContextThread(std::thread::id());
+    m_RenderThread = new RenderThread(s_Window,
+        [this](const FramePacket& packet) {
+            m_FrameStartMs = StartupReport::Now();
+            RenderFrame(packet);
+        },
+        [this](const FramePacket& packet) {
+            s_Startup.MarkFirstFrame();
+            if (packet.drawSplash)
+                s_Startup.MarkNotifyShown();
+            if (m_Replay)
+                AddReplayFrame(packet);
+            if (m_Bench)
+                m_Bench->AddFrame(packet.frameIndex, StartupReport::Now() - m_FrameStartMs,
+                    m_GpuTimer->GetCollectedFrameMs(), GpuTimer::kFramesInFlight, ChecksumFrame());
+            if (m_Load)
+                m_Load->OnPresented(packet, GetAppTime(), StartupReport::Now() - m_FrameStartMs,
+                    m_GpuTimer ? m_GpuTimer->GetCollectedFrameMs() : -1.0f);
+            AddFlightFrame(packet);
+        });
+    m_RenderThread->Start();
+    AllocTracker::TrackThisThread();
+    CpuProfiler::SetThreadName("simulation");
+
+    if (!m_Config.recordPath.empty())
+    {
+        m_Recorder = new SessionRecorder();
+        if (!m_Recorder->Open(m_Config.recordPath, GetAppTime()))
+        {
+            delete m_Recorder;
+            m_Recorder = nullptr;
+        }
+    }
+    if (m_Config.load.runFor > 0.0)
+        m_Load = new LoadTest(m_Config.load, GetAppTime());
 
-    m_Textures["uav_icon"] = LoadTexture( AssetPath("compass_objpoint_satallite.png").c_str() );
-    m_Textures["splash_icon"] = LoadTexture( AssetPath("crosshair_red.png").c_str() );
-
-    // Set the resolution for the shaders (only needed once)
-    s_BlurShader->Bind();
-    s_BlurShader->SetVec2("u_Resolution", { (float)m_Width, (float)m_Height });
-
-    while (m_Running && !s_Window->ShouldClose())
+    while (m_Running && (m_Replay || m_Bench || !s_Window->ShouldClose()))
     {
-        if( !m_Splash.active )
-            soundIter = 0;
+        // A replay isn't paced, its clock only moves by the step
+        if (m_Replay)
+        {
+            if (!m_Replay->Step())
+                break;
+        }
+        else if (m_Bench)
+        {
+            if (!m_Bench->Step(m_NotifyState == NotifyState::None && !g_PulseTextFX.active && m_NotifyQueue.IsEmpty()))
+                break;
+        }
+        else
+            s_Window->PollEvents(kSimTickSeconds);
+        PROFILE_ZONE("tick");
+        double tickStart = StartupReport::Now();
+        double now = GetAppTime();
+        m_FrameArena->Reset();
 
-        static bool enterWasDown = false;
-        bool enterIsDown = glfwGetKey(s_Window->GetNativeWindow(), GLFW_KEY_ENTER) == GLFW_PRESS;
-        if (enterIsDown && !enterWasDown)
         {
-            if( g_PulseTextFX.active )
-                std::cout << "Wait until pulsefxtext finishes" << std::endl;
-            else if( pulseActive )
-                std::cout << "Wait until pulsetext finishes" << std::endl;
-            else
+            PROFILE_ZONE("input");
+            static bool enterWasDown = false;
+            bool enterIsDown = s_Window->IsKeyDown(Key::Enter);
+            if (enterIsDown && !enterWasDown)
             {
-                NotifyMessage({
-                    "First Blood!",
-                    "You got the first kill. (^3+100^7)",
-                    m_Textures["splash_icon"],
-                    {0.75f, 0.25f, 0.25f}, 
-                    "splash"
-                });
+                if( g_PulseTextFX.active )
+                    std::cout << "Wait until pulsefxtext finishes" << std::endl;
+                else if( pulseActive )
+                    std::cout << "Wait until pulsetext finishes" << std::endl;
+                else
+                {
+                    NotifyMessage({
+                        .text = "First Blood!",
+                        .description = "You got the first kill. (^3+100^7)",
+                        .icon = IconId::CrosshairRed,
+                        .color = {0.75f, 0.25f, 0.25f},
+                        .style = SplashStyle{},
+                        .cues = { { SoundId::MpLastStand, 0.0 } }
+                    });
+                }
             }
-        }
-        enterWasDown = enterIsDown;
+            enterWasDown = enterIsDown;
 
-        static bool dWasDown = false;
-        bool dIsDown = glfwGetKey(s_Window->GetNativeWindow(), GLFW_KEY_D) == GLFW_PRESS;
-        if (dIsDown && !dWasDown)
-        {
-            if( g_PulseTextFX.active )
-                std::cout << "Wait until pulsefxtext finishes" << std::endl;
-            else if( pulseActive )
-                std::cout << "Wait until pulsetext finishes" << std::endl;
-            else
+            static bool dWasDown = false;
+            bool dIsDown = s_Window->IsKeyDown(Key::D);
+            if (dIsDown && !dWasDown)
             {
-                NotifyMessage({
-                    "3 Kill Streak!",
-                    "Press 6 for UAV.",
-                    m_Textures["uav_icon"],
-                    {0.25f, 0.75f, 0.25f}, 
-                    "killstreak"
-                });
+                if( g_PulseTextFX.active )
+                    std::cout << "Wait until pulsefxtext finishes" << std::endl;
+                else if( pulseActive )
+                    std::cout << "Wait until pulsetext finishes" << std::endl;
+                else
+                {
+                    NotifyMessage({
+                        .text = "3 Kill Streak!",
+                        .description = "Press 6 for UAV.",
+                        .icon = IconId::CompassObjpointSatallite,
+                        .color = {0.25f, 0.75f, 0.25f},
+                        .style = KillstreakStyle{},
+                        .cues = { { SoundId::MpKillstrkRadar, 0.0 } }
+                    });
+                }
             }
-        }
-        dWasDown = dIsDown;
+            dWasDown = dIsDown;
 
-        static bool aWasDown = false;
-        bool aIsDown = glfwGetKey(s_Window->GetNativeWindow(), GLFW_KEY_A) == GLFW_PRESS;
+            static bool aWasDown = false;
+            bool aIsDown = s_Window->IsKeyDown(Key::A);
 
-        if (aIsDown && !aWasDown)
-        {
-            if( g_PulseTextFX.active )
-                std::cout << "Wait until pulsefxtext finishes" << std::endl;
-            else if( m_Splash.active )
-                std::cout << "Wait for notifies to finish" << std::endl;
-            else
+            if (aIsDown && !aWasDown)
             {
-                if( !pulseActive )
+                if( g_PulseTextFX.active )
+                    std::cout << "Wait until pulsefxtext finishes" << std::endl;
+                else if( m_Splash.active )
+                    std::cout << "Wait for notifies to finish" << std::endl;
+                else
                 {
-                    m_NotifyState = NotifyState::Pulse;
-                    pulseActive = true;
+                    if( !pulseActive )
+                    {
+                        m_NotifyState = NotifyState::Pulse;
+                        pulseActive = true;
+                    }
+                    else if( pulseActive )
+                    {
+                        m_NotifyState = NotifyState::None;
+                        pulseActive = false;
+                    }
+                    FlightRecorder::Mark("glow pulse", pulseActive ? "on" : "off", StartupReport::Now());
+                    if (m_Recorder)
+                        m_Recorder->RecordGlowPulse(GetAppTime(), pulseActive);
                 }
+            }
+            aWasDown = aIsDown;
+
+            static bool sWasDown = false;
+            bool sIsDown = s_Window->IsKeyDown(Key::S);
+
+            if (sIsDown && !sWasDown)
+            {
+                if( m_Splash.active )
+                    std::cout << "Wait for notifies to finish" << std::endl;
                 else if( pulseActive )
+                    std::cout << "Wait until pulsetext finishes" << std::endl;
+                else
                 {
-                    m_NotifyState = NotifyState::None;
-                    pulseActive = false;
+                    StartPulseText(g_PulseTextFX, text);
+                    if (m_Recorder)
+                        m_Recorder->RecordPulseText(GetAppTime(), text);
                 }
             }
-        }
-        aWasDown = aIsDown;
+            sWasDown = sIsDown;
 
-        static bool sWasDown = false;
-        bool sIsDown = glfwGetKey(s_Window->GetNativeWindow(), GLFW_KEY_S) == GLFW_PRESS;
+            // Every benchmark scene starts from an empty screen and queue
+            if (m_Bench && m_Bench->IsSceneStart())
+            {
+                while (!m_NotifyQueue.IsEmpty())
+                    m_Sounds->ReleaseStream(m_NotifyQueue.Pop().announcerStream);
+                m_Cues->Cancel(m_SplashCues);
+                m_Cues->Cancel(m_PulseCues);
+                m_Sounds->ReleaseStream(m_Current.announcerStream);
+                m_Current.announcerStream = -1;
+                m_Splash = SplashAnim();
+                m_DoingNotify = false;
+                m_NotifyState = NotifyState::None;
+                pulseActive = false;
+                g_PulseTextFX.active = false;
+            }
 
-        if (sIsDown && !sWasDown)
-        {
-            if( m_Splash.active )
-                std::cout << "Wait for notifies to finish" << std::endl;
-            else if( pulseActive )
-                std::cout << "Wait until pulsetext finishes" << std::endl;
-            else
+            // A replay has no keys, the recording (or the benchmark scene) says what happened when
+            SessionEvent event;
+            while ((m_Replay && m_Replay->NextEvent(event)) || (m_Bench && m_Bench->NextEvent(event)))
             {
-                StartPulseText(g_PulseTextFX, text);
+                switch (event.kind)
+                {
+                    case SessionEventKind::Notify:
+                        NotifyMessage(std::move(event.notify));
+                        break;
+                    case SessionEventKind::GlowPulse:
+                        pulseActive = event.on;
+                        m_NotifyState = event.on ? NotifyState::Pulse : NotifyState::None;
+                        FlightRecorder::Mark("glow pulse", pulseActive ? "on" : "off", StartupReport::Now());
+                        break;
+                    case SessionEventKind::PulseText:
+                        StartPulseText(g_PulseTextFX, event.text);
+                        break;
+                    default:
+                        break;
+                }
             }
-        }
-        sWasDown = sIsDown;
 
-        glClearColor(0.05f, 0.05f, 0.08f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+            // Generated requests are only turned away when they can't share the screen: the glow
+            // pulse holds the notify state, a second typewriter would restart the running one.
+            // Notifications go to the queue while others run, so it gets exercised.
+            LoadKind kind;
+            while (m_Load && m_Load->NextRequest(now, event, kind))
+            {
+                bool busy = pulseActive || (kind == LoadKind::Pulse && g_PulseTextFX.active);
+                if (busy)
+                    m_Load->CountRejected(kind);
+                else if (kind == LoadKind::Pulse)
+                {
+                    StartPulseText(g_PulseTextFX, event.text);
+                    m_Load->OnPulseStarted(GetAppTime());
+                }
+                else
+                    NotifyMessage(std::move(event.notify));
+            }
+        }
 
-        if( g_PulseTextFX.active )
+        FramePacket& packet = m_RenderThread->BeginPacket();
+        packet.frameIndex = frameIndex++;
+        packet.time = now;
+        packet.drawSplash = false;
+        packet.drawPulseText = false;
+        packet.cueMarkers.clear();
+        if (!m_AudioReady && m_AudioJob.IsValid() && m_Jobs->IsDone(m_AudioJob))
+            m_AudioReady = true;
+        if (m_AudioReady)
         {
-            RenderPulseText(g_PulseTextFX, 360.0f, 540.0f);
+            PROFILE_ZONE("audio");
+            m_Cues->Update(now, packet.cueMarkers);
+            m_Sounds->Update();
         }
-        else
+
+        if (m_NotifyState == NotifyState::None && !g_PulseTextFX.active && m_NotifyQueue.IsEmpty())
+            RunIdlePrefetch();
+
+        if( g_PulseTextFX.active )
         {
-            g_PulseTextFX.lastPlayedIndex = -1;
-            g_PulseTextFX.playedDecaySound = false;
+            PROFILE_ZONE("animation");
+            UpdatePulseText(g_PulseTextFX, now);
+            packet.drawPulseText = true;
+            packet.pulseText = g_PulseTextFX;
+            packet.decayOrder.assign(decayOrder);
         }
 
         double alpha, x, scale = 1.0;
@@ -969,81 +1545,132 @@ void Application::Run()
         {
             case NotifyState::Splash:
             {
-                if (m_SplashType == "splash" && !m_NotifyQueue.empty())
                 {
-                    if (m_NotifyQueue.front().type == "killstreak" && m_Splash.phase == SplashPhase::In)
+                    PROFILE_ZONE("queue");
+                    if (YieldsToUrgent(m_Current.style) && !m_NotifyQueue.IsEmpty())
                     {
-                        const NotifyData& next = m_NotifyQueue.front();
-                        m_SplashText  = next.text;
-                        m_SplashDesc = next.description;
-                        m_SplashIcon = next.icon;
-                        m_SplashColor = next.color;
-                        m_Splash.phase = SplashPhase::Out;
-                        m_Splash.startTime = glfwGetTime();
-                        break;
+                        if (IsUrgent(m_NotifyQueue.Front().style) && m_Splash.phase == SplashPhase::In)
+                        {
+                            const NotifyData& next = m_NotifyQueue.Front();
+                            m_Current.text  = next.text;
+                            m_Current.description = next.description;
+                            m_Current.icon = next.icon;
+                            m_Current.color = next.color;
+                            m_Current.layout = nullptr; // measured for the other type's font
+                            m_Splash.phase = SplashPhase::Out;
+                            m_Splash.startTime = GetAppTime();
+                            if (m_Load)
+                                m_Load->CountCutShort();
+                            break;
+                        }
                     }
-                }
 
-                if (!m_Splash.active)
-                {
-                    m_DoingNotify = false;
-                
-                    if (!m_NotifyQueue.empty())
-                    {
-                        NotifyData next = m_NotifyQueue.front();
-                        m_NotifyQueue.pop_front();
-                        StartNotify(next);
-                    }
-                    else
+                    if (!m_Splash.active)
                     {
-                        m_NotifyState = NotifyState::None;
+                        m_DoingNotify = false;
+                
+                        if (!m_NotifyQueue.IsEmpty())
+                            StartNotify(m_NotifyQueue.Pop());
+                        else
+                        {
+                            m_NotifyState = NotifyState::None;
+                        }
+                        break;
                     }
-                    break;
-                }
 
-                if( m_Splash.WantsToFinish() )
-                {
-                    if( !m_NotifyQueue.empty() )
+                    if( m_Splash.WantsToFinish() )
                     {
-                        const NotifyData& next = m_NotifyQueue.front();
-                        if( next.type == m_SplashType )
+                        if( !m_NotifyQueue.IsEmpty() )
                         {
-                            if( m_SplashType != "killstreak" )
+                            const NotifyData& next = m_NotifyQueue.Front();
+                            if( SameStyle(next.style, m_Current.style) )
                             {
-                                soundIter = 0;
-                                m_Splash.active = false;
-                                NotifyData dataToStart = m_NotifyQueue.front();
-                                m_NotifyQueue.pop_front();
-                                StartNotify(dataToStart);
-                                break;
+                                if( ChainsSameStyle(m_Current.style) )
+                                {
+                                    m_Splash.active = false;
+                                    StartNotify(m_NotifyQueue.Pop());
+                                    break;
+                                }
                             }
                         }
                     }
                 }
 
-                if( m_SplashType == "killstreak" )
-                {
-                    m_Splash.Update();
-                    alpha = m_Splash.GetAlphaMW2();
-                    x     = m_Splash.GetSlideMW2(640.0);
-                    textScale = 0.6f;
-                }
-                else if( m_SplashType == "splash" )
-                {
-                    scale = m_Splash.GetValue(10.0, 1.0);
-                    alpha = m_Splash.GetValue(0.0, 1.0);
-                    x     = 0.0;
-                    textScale = 0.5f;
-                }
-                SplashNotify(m_SplashText, m_SplashDesc, m_SplashIcon, textScale, scale, alpha, x, m_SplashColor);
+                PROFILE_ZONE("animation");
+                SplashMotion motion = std::visit([this](auto style) { return decltype(style)::Animate(m_Splash); }, m_Current.style);
+                alpha = motion.alpha;
+                x     = motion.x;
+                scale = motion.scale;
+                textScale = motion.textScale;
+
+                SplashDrawData& splash = packet.splash;
+                splash.text        = m_Current.text;
+                splash.description = m_Current.description;
+                splash.icon        = m_Current.icon;
+                splash.color       = m_Current.color;
+                splash.style       = m_Current.style;
+                splash.textScale   = textScale;
+                splash.scale       = scale;
+                splash.alpha       = alpha;
+                splash.layout      = m_Current.layout;
+                splash.x           = x;
+                splash.id          = m_Current.id;
+                packet.drawSplash  = true;
                 break;
             }
             case NotifyState::Pulse:
-                glowPulse(text, 1.0f);
+                packet.glowText = text;
                 break;
             default:
                 break;
         }
-        s_Window->OnUpdate();
+        packet.state = m_NotifyState;
+        if (m_Load)
+            m_Load->OnTick(now, m_NotifyQueue.GetSize());
+
+        // Test hook (NOTIFY_ALLOC_TRACKING): while a notification, the glow
+        // pulse or the typewriter runs, ticks and frames have to get by without the heap.
+        // Not an assert, a release build with tracking has to fail as well.
+        uint64_t allocations = AllocTracker::TakeCount();
+        if (allocations > 0)
+        {
+            std::cerr << "[Alloc] " << allocations << " heap allocations while a notification was running" << std::endl;
+            std::abort();
+        }
+        AllocTracker::SetArmed(m_NotifyState != NotifyState::None || g_PulseTextFX.active);
+
+        packet.simMs = (float)(StartupReport::Now() - tickStart);
+        m_RenderThread->SubmitPacket();
+        // Lockstep, every replayed or benchmarked tick is drawn exactly once
+        if (m_Replay || m_Bench)
+            m_RenderThread->WaitForPresent();
+    }
+
+    m_RenderThread->Stop();
+    // The reports below allocate, the last frame may have left the tracker armed
+    AllocTracker::SetArmed(false);
+    m_Jobs->SetContextThread(std::this_thread::get_id());
+
+    if (m_Recorder)
+        m_Recorder->Close(GetAppTime());
+    if (m_Replay)
+    {
+        m_Replay->PrintReport(std::cout);
+        if (!m_Config.replayOut.empty())
+            m_Replay->WriteFrames(m_Config.replayOut);
     }
-}
\ No newline at end of file
+    if (m_Load)
+    {
+        size_t pending = m_NotifyQueue.GetSize() + (m_DoingNotify && m_Splash.active ? 1 : 0);
+        m_Load->PrintReport(std::cout, pending);
+        if (!m_Config.load.outPath.empty())
+            m_Load->WriteJson(m_Config.load.outPath, pending, m_RenderThread->GetDroppedPackets());
+    }
+
+    for (const BudgetCheck& check : m_BudgetChecks)
+    {
+        check.PrintReport(std::cout);
+        if (!check.Passed())
+            m_ExitCode = 1;
+    }
+}
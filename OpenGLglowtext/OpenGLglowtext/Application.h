@@ -1,16 +1,29 @@
 #pragma once
 #include "Shader.h"
+#include "FramePacket.h"
+#include "JobSystem.h"
+#include "StartupReport.h"
+#include "SplashAnim.h"
+#include "RingQueue.h"
+#include "FixedVector.h"
+#include "HeadlessWindow.h"
+#include "RenderStats.h"
+#include "LoadTest.h"
+#include "RenderBench.h"
+#include "FlightRecorder.h"
+#include "TextLayout.h"
 #include <glad/glad.h>
-#include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <vector>
-#include <deque>
+#include <string>
+#include <string_view>
 #include <map>
 #include <filesystem>
 #include <iostream>
 #include <algorithm>
 #include <numeric>
 #include <random>
+#include <memory>
 
 enum class TextAlignX
 {
@@ -25,136 +38,6 @@ enum class TextAlignY
     Top
 };
 
-struct Character
-{
-    GLuint TextureID;
-    glm::ivec2 Size;
-    glm::ivec2 Bearing;
-    GLuint Advance;
-};
-
-struct PulseTextFX
-{
-    std::string text;
-    float birthTime;
-    float letterDelay = 0.08f;
-    float pulseSpeed = 6.0f;
-    float holdTime = 2.0f;
-    float decayDuration = 1.0f;
-    int lastPlayedIndex = -1;
-    bool playedDecaySound = false;
-    bool active = false;
-};
-
-enum class SplashPhase
-{
-    In,
-    Hold,
-    Out,
-    Finished
-};
-
-struct SplashAnim {
-    double duration = 0.15;
-    double startTime = 0.0;
-    double holdTime    = 2.0;
-    bool active = false;
-    SplashPhase phase = SplashPhase::In;
-    void Start()
-    {
-        active = true;
-        phase = SplashPhase::In;
-        startTime = glfwGetTime();
-    }
-    bool WantsToFinish() const
-    {
-        return phase == SplashPhase::Hold &&
-            (glfwGetTime() - startTime) >= holdTime;
-    }
-    double EaseOut(double t)
-    {return 1.0 - pow(1.0 - t, 3.0);}
-    double GetValue(double from, double to) {
-        double now = glfwGetTime();
-        double elapsed = now - startTime;
-        switch (phase)
-        {
-        case SplashPhase::In:
-        {
-            double t = std::min(elapsed / duration, to);
-            if (t >= to)
-            {
-                phase = SplashPhase::Hold;
-                startTime = now;
-            }
-            return from + EaseOut(t) * (to - from);
-        }
-        case SplashPhase::Hold:
-        {
-            if (elapsed >= holdTime)
-            {
-                    phase = SplashPhase::Out;
-                    startTime = now;
-            }
-            return to;
-        }
-        case SplashPhase::Out:
-        {
-            double t = std::min(elapsed / duration, to);
-            if (t >= to)
-            {
-                phase = SplashPhase::Finished;
-                active = false;
-            }
-            return to + EaseOut(t) * (from - to);
-        }
-        default:
-            return 0.0;
-        }
-    }
-
-    void Update() {
-        if (!active) return;
-        double elapsed = glfwGetTime() - startTime;
-        if (elapsed >= (phase == SplashPhase::Hold ? holdTime : duration)) {
-            if (phase == SplashPhase::In) {
-                phase = SplashPhase::Hold;
-                startTime = glfwGetTime();
-            } else if (phase == SplashPhase::Hold) {
-                phase = SplashPhase::Out;
-                startTime = glfwGetTime();
-            } else if (phase == SplashPhase::Out) {
-                phase = SplashPhase::Finished;
-                active = false;
-            }
-        }
-    }
-
-    double GetProgress() {
-        double elapsed = glfwGetTime() - startTime;
-        return std::min(elapsed / duration, 1.0);
-    }
-
-    double GetAlphaMW2() {
-        double t = GetProgress();
-        if (phase == SplashPhase::In)   return std::min(t * 2.0, 1.0);
-        if (phase == SplashPhase::Hold) return 1.0;
-        if (phase == SplashPhase::Out)  return 1.0 - t;
-        return 0.0;
-    }
-
-    double GetSlideMW2(double offset) {
-        double t = EaseOut(GetProgress());
-        if (phase == SplashPhase::In)   return -offset + (t * offset);
-        if (phase == SplashPhase::Hold) return 0.0;
-        if (phase == SplashPhase::Out)  return t * offset;
-        return 0.0;
-    }
-    bool IsFinished() const
-    {return phase == SplashPhase::Finished;}
-    bool IsEnding() const
-    {return phase == SplashPhase::Out;}
-};
-
 struct PulseFX
 {
     bool active = false;
@@ -164,68 +47,160 @@ struct PulseFX
     int decayDurationMs = 1000;
 };
 
+// Moved into the notification queue and from there into the running
+// notification, never copied on the way. Text and cues are stored inline,
+// building one doesn't allocate either.
 struct NotifyData
 {
-    std::string text;
-    std::string description;
-    GLuint      icon;
-    glm::vec3   color;
-    std::string type;
+    NotifyText  text;
+    NotifyDescription description;
+    IconId      icon = IconId::None;
+    glm::vec3   color = glm::vec3(1.0f);
+    NotifyStyle style = SplashStyle{};
+    FixedVector<AudioCue, 4> cues = {};
+    NotifyText  announcer = {};     // optional streamed voice line (assets relative)
+    int         announcerStream = -1;
+    std::shared_ptr<SplashLayout> layout = {};  // built while the notification waits in the queue
+    uint32_t    id = 0;                     // numbered from 1 by NotifyMessage
 };
 
-enum class NotifyState
+class RenderThread;
+class SoundBank;
+class CueScheduler;
+class TextureLoader;
+class FrameArena;
+class GpuTimer;
+class SessionRecorder;
+class SessionReplay;
+class RenderBench;
+
+struct AppConfig
 {
-    None,
+    bool nullAudio = false; // --null-audio: mix without an output device
+    bool headless = false;  // --headless: render offscreen through EGL instead of a window (Linux)
+    HeadlessConfig headlessRun;
+    bool gpuTiming = false;     // --gpu-timing: time the render passes, report on exit
+    bool gpuOverlay = false;    // --gpu-overlay: draw the pass timings on screen (implies --gpu-timing)
+    std::string gpuTimingOut;   // --gpu-timing-out <file.csv|file.json>: dump them periodically (implies --gpu-timing)
+    bool checkBudgets = false;  // --check-budgets: count GL calls per frame, fail the run when a frame goes over its budget
+    std::string recordPath;     // --record <file>: write the notifications and pulses of the session to a file
+    std::string replayPath;     // --replay <file>: play a recorded session back, headless and as fast as it renders
+    double replayStep = 1.0 / 60.0; // --replay-step <seconds>: simulated time per replayed frame
+    std::string replayOut;      // --replay-out <file.csv>: timing (and checksum) of every replayed frame
+    bool frameChecksums = false; // --frame-checksums: hash the pixels of every replayed frame
+    LoadConfig load;            // --load-test <seconds> and friends: drive the notifications with synthetic load
+    RenderBenchConfig renderBench; // --render-bench and friends: time canned scenes, one Application per resolution
+    FlightConfig flight;        // --hitch-budget and --hitch-dir: snapshot the frames and events around a hitch
+    GLDebugMode glDebug = GLDebug::kDefaultMode; // --gl-debug <off|async|sync>: driver messages, counted and reported on exit
+    int width = 1280;           // framebuffer size, the layout is 1280x720 and scaled to it
+    int height = 720;
+};
+
+// Kinds of frames that have a FrameBudget
+enum class FrameScenario
+{
+    Idle,
     Splash,
-    Pulse
+    Killstreak,
+    Typewriter,
+    GlowPulse,
+    Count
 };
 
 class Application
 {
 public:
-    Application();
+    Application(const AppConfig& config);
     ~Application();
 
     void Run();
+    // Non zero when a check of the run failed (--check-budgets)
+    int GetExitCode() const { return m_ExitCode; }
+    // The scenes timed by Run() with --render-bench
+    std::vector<RenderBench::SceneResult> GetBenchResults() const;
 
 private:
+    AppConfig m_Config;
     bool m_Running = true;
+    int m_ExitCode = 0;
 
     SplashAnim m_Splash;
     NotifyState m_NotifyState = NotifyState::None;
 
-    Shader* s_BlurShader;
-
-    GLuint m_FBO;
-    GLuint m_FBOTexture;
+    Shader* s_BlurShader = nullptr;
+    RenderThread* m_RenderThread = nullptr;
+    JobSystem* m_Jobs = nullptr;
+    SoundBank* m_Sounds = nullptr;
+    CueScheduler* m_Cues = nullptr;
+    TextureLoader* m_TextureLoader = nullptr;
+    FrameArena* m_FrameArena = nullptr;     // simulation thread, reset every tick
+    GpuTimer* m_GpuTimer = nullptr;         // render thread, null unless timing was asked for
+    double m_NextGpuDump = 0.0;
+    bool m_GpuDumpStarted = false;
+    std::vector<BudgetCheck> m_BudgetChecks; // render thread, one per FrameScenario with --check-budgets
+    SessionRecorder* m_Recorder = nullptr;  // simulation thread, with --record
+    SessionReplay* m_Replay = nullptr;      // with --replay, the render thread adds its frames
+    LoadTest* m_Load = nullptr;             // with --load-test, both threads report to it
+    RenderBench* m_Bench = nullptr;         // with --render-bench, the render thread adds its frames
+    uint32_t m_NextNotifyId = 0;
+    double m_FrameStartMs = 0.0;            // render thread
+    double m_LastPresentMs = 0.0;           // render thread, 0 before the first present
+    std::vector<unsigned char> m_FramePixels; // render thread, read back for --frame-checksums
+    int m_SplashCues = 0;
+    int m_PulseCues = 0;
+
+    // Lazily initialized subsystems. Audio belongs to the simulation
+    // thread, the text and glow pipelines to the render thread.
+    JobHandle m_AudioJob;
+    bool m_AudioReady = false;
+    bool m_TextReady = false;
+    bool m_GlowReady = false;
+    size_t m_NextPrefetch = 0;
+    JobHandle m_PrefetchJob;
+    JobHandle m_FontPrefetches[(int)FontId::Count];
+
+    GLuint m_FBO = 0;
+    GLuint m_FBOTexture = 0;
     int m_Width, m_Height;
 
-    GLuint m_QuadVAO, m_QuadVBO;
+    GLuint m_QuadVAO = 0, m_QuadVBO = 0;
 
-    std::string m_SplashText;
-    std::string m_SplashDesc;
-    GLuint      m_SplashIcon;
-    glm::vec3   m_SplashColor = glm::vec3(1.0f);
-    std::string m_SplashType;
+    static constexpr size_t kMaxQueuedNotifies = 16;
 
-    std::map<std::string, GLuint> m_Textures;
+    NotifyData m_Current;   // the splash / killstreak on screen
     bool m_DoingNotify = false;
-    std::deque<NotifyData> m_NotifyQueue;
+    RingQueue<NotifyData, kMaxQueuedNotifies> m_NotifyQueue;
 
     void InitFBO(int width, int height);
     void InitScreenQuad();
+    void StartAudio(InitTrigger trigger);
+    void EnsureAudio();
+    void EnsureTextPipeline(InitTrigger trigger);
+    void EnsureGlowPipeline(InitTrigger trigger);
+    JobHandle PrefetchFont(FontId id);
+    void RunIdlePrefetch();
+    void PrefetchNotify(NotifyData& data);
+    void PreloadForReplay();
+    void AddReplayFrame(const FramePacket& packet);
+    void AddFlightFrame(const FramePacket& packet);
+    uint64_t ChecksumFrame();
     void RenderScreenQuad();
-    void SplashNotify(const std::string& text, const std::string& desc, GLuint icon, float textScale, double scale, double alpha, double x, const glm::vec3& color);
-    void glowPulse(const std::string& text, float textScale);
-    void StartNotify(const NotifyData& data);
-    void NotifyMessage(const NotifyData& data);
-    void RenderPulseText(PulseTextFX& fx, float baseX, float baseY);
+    void RenderFrame(const FramePacket& packet);
+    void DrawGpuOverlay();
+    void WriteGpuTimings();
+    void SplashNotify(const SplashDrawData& data);
+    template <typename Style>
+    void DrawSplash(const SplashDrawData& data);
+    void glowPulse(std::string_view text, float textScale, double time);
+    void StartNotify(NotifyData&& data);
+    void NotifyMessage(NotifyData&& data);
+    void RenderPulseText(const FramePacket& packet, float baseX, float baseY);
     //void textPulse(const std::string& text, float x, float y, float textScale, TextAlignX alignX, TextAlignY alignY, float alpha);
-    void StartPulseText(PulseTextFX& fx, const std::string& text);
+    void StartPulseText(PulseTextFX& fx, std::string_view text);
+    void UpdatePulseText(PulseTextFX& fx, double now);
     char GetStableRandomChar(int index, int seed);
-    void DrawPulseTextLayers(PulseTextFX& fx, float baseX, float baseY, bool isFboPass, bool endFX);
-    void RenderColoredText(const std::string& text, float x, float y, float scale, float alpha);
-    float GetTextWidth(const std::string& text, float scale);
-    void RenderIcon(GLuint textureID, float x, float y, float w, float h, float alpha);
-    void playNotifySound(const char* pFilePath);
+    void DrawPulseTextLayers(const FramePacket& packet, float baseX, float baseY);
+    void RenderColoredText(std::string_view text, float x, float y, float scale, float alpha);
+    float GetTextWidth(std::string_view text, float scale);
+    void RenderIcon(IconId icon, float x, float y, float w, float h, float alpha);
 };
\ No newline at end of file
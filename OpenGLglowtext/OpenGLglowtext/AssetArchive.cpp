@@ -0,0 +1,218 @@
+#include "AssetArchive.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+AssetArchive::~AssetArchive()
+{
+    Unmap();
+}
+
+bool AssetArchive::Open(const std::string& archivePath, const std::string& looseRoot, uint64_t manifestStamp)
+{
+    m_LooseRoot = looseRoot;
+    Unmap();
+
+#ifdef _WIN32
+    // Sequential scan makes the cache manager read ahead in large chunks
+    HANDLE file = CreateFileA(archivePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view)
+    {
+        std::cerr << "[Assets] Failed to map: " << archivePath << std::endl;
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    m_File = file;
+    m_Mapping = mapping;
+    m_Base = (const unsigned char*)view;
+    m_MappedSize = (size_t)size.QuadPart;
+
+    // Fault the whole file in with one large read instead of page by page
+    WIN32_MEMORY_RANGE_ENTRY range = { view, m_MappedSize };
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    int fd = open(archivePath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+        view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED)
+    {
+        std::cerr << "[Assets] Failed to map: " << archivePath << std::endl;
+        return false;
+    }
+    m_Base = (const unsigned char*)view;
+    m_MappedSize = (size_t)info.st_size;
+
+    madvise(view, m_MappedSize, MADV_SEQUENTIAL);
+    madvise(view, m_MappedSize, MADV_WILLNEED);
+#endif
+
+    if (!Validate())
+    {
+        std::cerr << "[Assets] Not an asset archive (or an old one): " << archivePath << std::endl;
+        Unmap();
+        return false;
+    }
+
+    const ArchiveHeader* header = (const ArchiveHeader*)m_Base;
+    m_EntryCount = header->entryCount;
+    m_NameTableSize = header->nameTableSize;
+    m_Index = (const ArchiveEntry*)(m_Base + sizeof(ArchiveHeader));
+    m_Names = (const char*)(m_Index + m_EntryCount);
+    m_MatchesManifest = manifestStamp != 0 && ArchiveStamp(m_Index, m_EntryCount) == manifestStamp;
+    if (manifestStamp != 0 && !m_MatchesManifest)
+        std::cerr << "[Assets] " << archivePath << " doesn't match AssetManifest.h, run the pre-build step again" << std::endl;
+
+    std::cout << "[Assets] " << archivePath << ": " << m_EntryCount << " entries, "
+              << m_MappedSize / 1024 << " KB mapped" << std::endl;
+    return true;
+}
+
+bool AssetArchive::Validate() const
+{
+    if (m_MappedSize < sizeof(ArchiveHeader))
+        return false;
+
+    const ArchiveHeader* header = (const ArchiveHeader*)m_Base;
+    if (memcmp(header->magic, kArchiveMagic, 4) != 0 || header->version != kArchiveVersion)
+        return false;
+
+    size_t tableEnd = sizeof(ArchiveHeader) + (size_t)header->entryCount * sizeof(ArchiveEntry) + header->nameTableSize;
+    if (tableEnd > m_MappedSize)
+        return false;
+
+    const ArchiveEntry* index = (const ArchiveEntry*)(m_Base + sizeof(ArchiveHeader));
+    for (uint32_t i = 0; i < header->entryCount; i++)
+    {
+        const ArchiveEntry& entry = index[i];
+        if (entry.offset > m_MappedSize || entry.size > m_MappedSize - entry.offset)
+            return false;
+        if (entry.nameOffset >= header->nameTableSize || entry.compression != (uint32_t)AssetCompression::None)
+            return false;
+        if (i > 0 && index[i - 1].hash >= entry.hash)
+            return false;
+    }
+    return true;
+}
+
+void AssetArchive::Unmap()
+{
+    if (!m_Base)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_Base);
+    CloseHandle((HANDLE)m_Mapping);
+    CloseHandle((HANDLE)m_File);
+    m_Mapping = nullptr;
+    m_File = nullptr;
+#else
+    munmap((void*)m_Base, m_MappedSize);
+#endif
+    m_Base = nullptr;
+    m_MappedSize = 0;
+    m_Index = nullptr;
+    m_Names = nullptr;
+    m_EntryCount = 0;
+    m_NameTableSize = 0;
+    m_MatchesManifest = false;
+}
+
+const ArchiveEntry* AssetArchive::Find(std::string_view name, uint64_t hash) const
+{
+    if (!m_Index)
+        return nullptr;
+
+    const ArchiveEntry* end = m_Index + m_EntryCount;
+    const ArchiveEntry* entry = std::lower_bound(m_Index, end, hash,
+        [](const ArchiveEntry& e, uint64_t h) { return e.hash < h; });
+    if (entry == end || entry->hash != hash)
+        return nullptr;
+
+    // Hashes are unique per archive, the name only guards against a miss
+    // that collides with a packed asset
+    const char* stored = m_Names + entry->nameOffset;
+    size_t maxLength = m_NameTableSize - entry->nameOffset;
+    if (strnlen(stored, maxLength) != name.size() || memcmp(stored, name.data(), name.size()) != 0)
+        return nullptr;
+    return entry;
+}
+
+AssetBlob AssetArchive::Load(std::string_view name)
+{
+    if (const ArchiveEntry* entry = Find(name, AssetHash(name)))
+        return { m_Base + entry->offset, (size_t)entry->size };
+
+    std::lock_guard<std::mutex> lock(m_LooseMutex);
+    auto it = m_Loose.find(name);
+    if (it == m_Loose.end())
+    {
+        std::ifstream file(m_LooseRoot + "/" + std::string(name), std::ios::binary | std::ios::ate);
+        if (!file)
+            return {};
+
+        std::vector<unsigned char> bytes((size_t)file.tellg());
+        file.seekg(0);
+        file.read((char*)bytes.data(), bytes.size());
+        if (!file)
+            return {};
+        it = m_Loose.emplace(std::string(name), std::move(bytes)).first;
+    }
+    // Empty files still get a valid pointer
+    static const unsigned char s_Empty = 0;
+    return { it->second.empty() ? &s_Empty : it->second.data(), it->second.size() };
+}
+
+AssetBlob AssetArchive::Load(const AssetRef& asset)
+{
+    // Same archive the manifest was generated from, no lookup at all
+    if (m_MatchesManifest)
+        return { m_Base + asset.offset, (size_t)asset.size };
+    if (const ArchiveEntry* entry = Find(asset.name, asset.hash))
+        return { m_Base + entry->offset, (size_t)entry->size };
+    return Load(std::string_view(asset.name));
+}
+
+bool AssetArchive::Contains(const AssetRef& asset) const
+{
+    return m_MatchesManifest || Contains(std::string_view(asset.name));
+}
+
+bool AssetArchive::Contains(std::string_view name) const
+{
+    if (Find(name, AssetHash(name)))
+        return true;
+    {
+        std::lock_guard<std::mutex> lock(m_LooseMutex);
+        if (m_Loose.find(name) != m_Loose.end())
+            return true;
+    }
+    return std::filesystem::is_regular_file(m_LooseRoot + "/" + std::string(name));
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include <initializer_list>
+
+// FNV-1a of an asset name. Names are relative to the exe folder with
+// forward slashes: "assets/crosshair_red.png", "shaders/text.vert"
+constexpr uint64_t AssetHash(std::string_view name)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : name)
+    {
+        hash ^= (unsigned char)c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+enum class AssetCompression : uint32_t
+{
+    None  // stored as is, the blob is a view into the mapping
+};
+
+// On disk: header, index sorted by hash, name table (zero terminated
+// names), then the data of every entry at an aligned offset
+struct ArchiveHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t nameTableSize;
+};
+
+struct ArchiveEntry
+{
+    uint64_t hash;
+    uint64_t offset;  // from the start of the archive
+    uint64_t size;
+    uint32_t compression;
+    uint32_t nameOffset;  // into the name table
+};
+
+static constexpr char kArchiveMagic[4] = { 'G', 'P', 'A', 'K' };
+static constexpr uint32_t kArchiveVersion = 1;
+static constexpr size_t kArchiveAlignment = 16;
+
+// Identifies one archive layout, the generated manifest records the stamp
+// of the archive its offsets were taken from
+inline uint64_t ArchiveStamp(const ArchiveEntry* index, uint32_t count)
+{
+    uint64_t stamp = 14695981039346656037ull;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        for (uint64_t value : { index[i].hash, index[i].offset, index[i].size })
+        {
+            stamp ^= value;
+            stamp *= 1099511628211ull;
+        }
+    }
+    return stamp;
+}
+
+// One asset of the generated manifest (AssetManifest.h). offset and size
+// are only valid in the archive with the manifest's stamp.
+struct AssetRef
+{
+    const char* name;
+    uint64_t hash;
+    uint64_t offset;
+    uint64_t size;
+
+    // The file name without its folder
+    constexpr const char* File() const
+    {
+        const char* file = name;
+        for (const char* c = name; *c; c++)
+        {
+            if (*c == '/')
+                file = c + 1;
+        }
+        return file;
+    }
+};
+
+// Bytes of one asset. Valid until the archive is destroyed.
+struct AssetBlob
+{
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+    std::string_view AsText() const { return { (const char*)data, size }; }
+};
+
+// Every asset of the app in one file (built by AssetCook --pack), mapped
+// once at startup. Loads are a binary search in the index and hand out a
+// pointer into the mapping, nothing is read or copied up front.
+// Names that aren't in the archive are read from loose files below the
+// loose root and kept in memory, so the app still runs from a plain
+// folder during development.
+class AssetArchive
+{
+public:
+    AssetArchive() = default;
+    ~AssetArchive();
+
+    // False when there is no usable archive, loads then only use loose files.
+    // The offsets of manifest assets are used as is when the archive has
+    // manifestStamp, otherwise they are looked up by hash like any name.
+    bool Open(const std::string& archivePath, const std::string& looseRoot, uint64_t manifestStamp = 0);
+
+    // Thread safe. Empty blob when the asset doesn't exist anywhere.
+    AssetBlob Load(std::string_view name);
+    AssetBlob Load(const AssetRef& asset);
+    bool Contains(std::string_view name) const;
+    bool Contains(const AssetRef& asset) const;
+
+    bool IsMapped() const { return m_Base != nullptr; }
+    size_t GetMappedSize() const { return m_MappedSize; }
+    uint32_t GetEntryCount() const { return m_EntryCount; }
+
+private:
+    const ArchiveEntry* Find(std::string_view name, uint64_t hash) const;
+    bool Validate() const;
+    void Unmap();
+
+    const unsigned char* m_Base = nullptr;
+    size_t m_MappedSize = 0;
+    const ArchiveEntry* m_Index = nullptr;
+    const char* m_Names = nullptr;
+    uint32_t m_EntryCount = 0;
+    uint32_t m_NameTableSize = 0;
+    bool m_MatchesManifest = false;
+#ifdef _WIN32
+    void* m_File = nullptr;     // HANDLEs, keeps windows.h out of the header
+    void* m_Mapping = nullptr;
+#endif
+
+    std::string m_LooseRoot;
+    mutable std::mutex m_LooseMutex;
+    // Node based, a loose blob never moves once loaded
+    std::map<std::string, std::vector<unsigned char>, std::less<>> m_Loose;
+};
@@ -0,0 +1,80 @@
+// Generated by AssetCook --manifest from assets.pak, do not edit.
+// Every asset of the app as a typed id. The ids index the AssetRef tables,
+// whose offsets are valid in the archive with kManifestStamp.
+#pragma once
+#include "AssetArchive.h"
+
+inline constexpr uint64_t kManifestStamp = 0xfa3677c0120bde80ull;
+
+enum class FontId
+{
+    BankGothicMediumBt,
+    CarbonBold,
+    ConduitItcStdFont,
+    MsReferenceSansSerifBold,
+    OldR,
+    VcrOsdMono1001,
+    Count
+};
+
+inline constexpr AssetRef kFontAssets[] = {
+    { "assets/bank-gothic-medium-bt.ttf", AssetHash("assets/bank-gothic-medium-bt.ttf"), 237088, 35908 },
+    { "assets/Carbon-Bold.ttf", AssetHash("assets/Carbon-Bold.ttf"), 273008, 20948 },
+    { "assets/Conduit-ITC-Std-Font.otf", AssetHash("assets/Conduit-ITC-Std-Font.otf"), 1552528, 46224 },
+    { "assets/MS Reference Sans Serif Bold.ttf", AssetHash("assets/MS Reference Sans Serif Bold.ttf"), 1048384, 218516 },
+    { "assets/Old_R.ttf", AssetHash("assets/Old_R.ttf"), 570896, 56492 },
+    { "assets/VCR_OSD_MONO_1.001.ttf", AssetHash("assets/VCR_OSD_MONO_1.001.ttf"), 26688, 75864 },
+};
+
+constexpr const AssetRef& GetAsset(FontId id) { return kFontAssets[(int)id]; }
+
+enum class IconId
+{
+    None = -1,
+    CompassObjpointSatallite,
+    CrosshairRed,
+    Count
+};
+
+inline constexpr AssetRef kIconAssets[] = {
+    { "assets/compass_objpoint_satallite.png", AssetHash("assets/compass_objpoint_satallite.png"), 1547840, 4677 },
+    { "assets/crosshair_red.png", AssetHash("assets/crosshair_red.png"), 566192, 4701 },
+};
+
+constexpr const AssetRef& GetAsset(IconId id) { return kIconAssets[(int)id]; }
+
+enum class SoundId
+{
+    MpKillstrkRadar,
+    MpLastStand,
+    UiComputerTextBlip1x,
+    UiComputerTextDelete1,
+    Count
+};
+
+inline constexpr AssetRef kSoundAssets[] = {
+    { "assets/mp_killstrk_radar.wav", AssetHash("assets/mp_killstrk_radar.wav"), 103264, 133812 },
+    { "assets/mp_last_stand.wav", AssetHash("assets/mp_last_stand.wav"), 627392, 420986 },
+    { "assets/ui_computer_text_blip1x.wav", AssetHash("assets/ui_computer_text_blip1x.wav"), 1568, 2724 },
+    { "assets/ui_computer_text_delete1.wav", AssetHash("assets/ui_computer_text_delete1.wav"), 1266912, 106120 },
+};
+
+constexpr const AssetRef& GetAsset(SoundId id) { return kSoundAssets[(int)id]; }
+
+enum class ShaderId
+{
+    BlurFrag,
+    ScreenVert,
+    TextFrag,
+    TextVert,
+    Count
+};
+
+inline constexpr AssetRef kShaderAssets[] = {
+    { "shaders/blur.frag", AssetHash("shaders/blur.frag"), 1546672, 1159 },
+    { "shaders/screen.vert", AssetHash("shaders/screen.vert"), 1373040, 207 },
+    { "shaders/text.frag", AssetHash("shaders/text.frag"), 102560, 698 },
+    { "shaders/text.vert", AssetHash("shaders/text.vert"), 4304, 450 },
+};
+
+constexpr const AssetRef& GetAsset(ShaderId id) { return kShaderAssets[(int)id]; }
@@ -0,0 +1,95 @@
+#include "AudioCues.h"
+#include "SoundBank.h"
+#include <algorithm>
+#include <iomanip>
+
+CueScheduler::CueScheduler(SoundBank* sounds)
+    : m_Sounds(sounds)
+{
+    m_Cues.reserve(64);
+}
+
+int CueScheduler::Begin(std::span<const AudioCue> cues, double startTime)
+{
+    int timeline = m_NextTimeline++;
+    for (const AudioCue& cue : cues)
+    {
+        PendingCue pending;
+        pending.timeline = timeline;
+        pending.sound = cue.sound;
+        pending.stream = cue.stream;
+        pending.time = startTime + cue.offset;
+        m_Cues.push_back(pending);
+    }
+    return timeline;
+}
+
+void CueScheduler::Cancel(int timeline)
+{
+    for (const PendingCue& cue : m_Cues)
+    {
+        if (cue.timeline == timeline && !cue.scheduled && cue.stream >= 0)
+            m_Sounds->ReleaseStream(cue.stream);
+    }
+    m_Cues.erase(std::remove_if(m_Cues.begin(), m_Cues.end(),
+        [timeline](const PendingCue& cue) { return cue.timeline == timeline && !cue.scheduled; }),
+        m_Cues.end());
+}
+
+void CueScheduler::Update(double now, CueMarkers& crossed)
+{
+    uint32_t sampleRate = m_Sounds->GetSampleRate();
+    uint64_t engineNow = m_Sounds->GetTimeInFrames();
+
+    for (PendingCue& cue : m_Cues)
+    {
+        if (!cue.scheduled && cue.time <= now + kLookahead)
+        {
+            // Map the app clock onto the engine clock around "now"
+            double lead = std::max(cue.time - now, 0.0);
+            uint64_t startFrame = engineNow + (uint64_t)(lead * sampleRate);
+            if (cue.stream >= 0)
+                m_Sounds->PlayStream(cue.stream, startFrame);
+            else
+                m_Sounds->PlayAt(cue.sound, startFrame);
+            cue.scheduled = true;
+            cue.audioTime = now + lead;
+        }
+        if (cue.scheduled && cue.time <= now)
+        {
+            crossed.push_back({ cue.audioTime });
+            cue.timeline = 0; // done
+        }
+    }
+
+    m_Cues.erase(std::remove_if(m_Cues.begin(), m_Cues.end(),
+        [](const PendingCue& cue) { return cue.timeline == 0; }),
+        m_Cues.end());
+}
+
+void CueScheduler::RecordSkew(double seconds)
+{
+    std::lock_guard<std::mutex> lock(m_StatsMutex);
+    if (m_SkewCount == 0)
+    {
+        m_SkewMin = seconds;
+        m_SkewMax = seconds;
+    }
+    m_SkewMin = std::min(m_SkewMin, seconds);
+    m_SkewMax = std::max(m_SkewMax, seconds);
+    m_SkewSum += seconds;
+    m_SkewCount++;
+}
+
+void CueScheduler::PrintReport(std::ostream& out) const
+{
+    std::lock_guard<std::mutex> lock(m_StatsMutex);
+    if (m_SkewCount == 0)
+        return;
+
+    // Positive: the frame showing the cue was submitted after the audio started
+    out << std::fixed << std::setprecision(2)
+        << "[Audio] cue-to-frame skew over " << m_SkewCount << " cues: avg "
+        << m_SkewSum / m_SkewCount * 1000.0 << " ms, min " << m_SkewMin * 1000.0
+        << " ms, max " << m_SkewMax * 1000.0 << " ms" << std::endl;
+}
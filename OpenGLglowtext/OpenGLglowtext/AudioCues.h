@@ -0,0 +1,74 @@
+#pragma once
+#include "FixedVector.h"
+#include <vector>
+#include <span>
+#include <mutex>
+#include <ostream>
+#include <cstdint>
+
+class SoundBank;
+enum class SoundId;
+
+// A sound that belongs to a notification, `offset` seconds after it starts.
+// With `stream` set it plays a prefetched SoundBank stream instead of `sound`.
+struct AudioCue
+{
+    SoundId sound;
+    double offset;
+    int stream = -1;
+};
+
+// Emitted by the simulation when the visuals reach a cue's offset, carries
+// the (estimated) time the audio starts so the render side can measure skew
+struct CueMarker
+{
+    double audioTime;
+};
+
+// The markers of one tick, stored inline in the frame packet
+using CueMarkers = FixedVector<CueMarker, 16>;
+
+// Schedules notification cues on the audio engine clock instead of firing
+// them from frame counters. Cues are handed to the engine once they enter
+// the lookahead window, with a PCM start time that matches their offset.
+class CueScheduler
+{
+public:
+    static constexpr double kLookahead = 0.1;
+
+    explicit CueScheduler(SoundBank* sounds);
+
+    // Anchors a cue timeline at app time `startTime`, returns its handle
+    int Begin(std::span<const AudioCue> cues, double startTime);
+    // Drops the cues of a timeline that were not handed to the engine yet
+    void Cancel(int timeline);
+
+    // Simulation tick. Appends a marker for every cue whose offset was
+    // crossed at `now` (while there is room, they only feed the skew stats).
+    void Update(double now, CueMarkers& crossed);
+
+    // Thread safe, called by the render thread once the frame is submitted
+    void RecordSkew(double seconds);
+    void PrintReport(std::ostream& out) const;
+
+private:
+    struct PendingCue
+    {
+        int timeline;
+        SoundId sound;
+        int stream;
+        double time;
+        bool scheduled = false;
+        double audioTime = 0.0;
+    };
+
+    SoundBank* m_Sounds;
+    std::vector<PendingCue> m_Cues;
+    int m_NextTimeline = 1;
+
+    mutable std::mutex m_StatsMutex;
+    uint64_t m_SkewCount = 0;
+    double m_SkewSum = 0.0;
+    double m_SkewMin = 0.0;
+    double m_SkewMax = 0.0;
+};
@@ -0,0 +1,187 @@
+#include "CpuProfiler.h"
+#include "AllocTracker.h"
+
+#if NOTIFY_PROFILE_ZONES
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct ZoneEvent
+    {
+        const char* name;
+        const char* detail;
+        uint64_t startNs;
+        uint64_t endNs;
+    };
+
+    // Written only by its thread. count and next are published after the
+    // event / chunk is complete, so the reader never sees a half written one.
+    struct EventChunk
+    {
+        ZoneEvent events[CpuProfiler::kEventsPerChunk];
+        std::atomic<uint32_t> count = 0;
+        std::atomic<EventChunk*> next = nullptr;
+    };
+
+    struct ThreadBuffer
+    {
+        int tid = 0;
+        std::string name;
+        EventChunk* first = nullptr;
+        EventChunk* last = nullptr;     // owning thread only
+        uint32_t chunks = 0;
+        std::atomic<uint64_t> dropped = 0;
+
+        ~ThreadBuffer()
+        {
+            while (first)
+                delete std::exchange(first, first->next.load());
+        }
+    };
+}
+
+static const std::chrono::steady_clock::time_point s_ProcessStart = std::chrono::steady_clock::now();
+static std::atomic<bool> s_Recording = false;
+
+// Only touched when a thread records its first zone or names itself
+static std::mutex s_BuffersMutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> s_Buffers;
+static thread_local ThreadBuffer* t_Buffer = nullptr;
+static thread_local std::string t_ThreadName;
+
+static ThreadBuffer* CreateThreadBuffer()
+{
+    AllocPause pause;
+    std::lock_guard<std::mutex> lock(s_BuffersMutex);
+    std::unique_ptr<ThreadBuffer> buffer = std::make_unique<ThreadBuffer>();
+    buffer->tid = (int)s_Buffers.size() + 1;
+    buffer->name = t_ThreadName.empty() ? "thread " + std::to_string(buffer->tid) : t_ThreadName;
+    buffer->first = buffer->last = new EventChunk();
+    buffer->chunks = 1;
+    s_Buffers.push_back(std::move(buffer));
+    return s_Buffers.back().get();
+}
+
+void CpuProfiler::Start()
+{
+    s_Recording = true;
+}
+
+bool CpuProfiler::IsRecording()
+{
+    return s_Recording.load(std::memory_order_relaxed);
+}
+
+void CpuProfiler::SetThreadName(const std::string& name)
+{
+    t_ThreadName = name;
+    if (t_Buffer)
+    {
+        std::lock_guard<std::mutex> lock(s_BuffersMutex);
+        t_Buffer->name = name;
+    }
+}
+
+uint64_t CpuProfiler::Now()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_ProcessStart).count();
+}
+
+void CpuProfiler::Record(const char* name, const char* detail, uint64_t startNs, uint64_t endNs)
+{
+    if (!t_Buffer)
+        t_Buffer = CreateThreadBuffer();
+
+    EventChunk* chunk = t_Buffer->last;
+    uint32_t index = chunk->count.load(std::memory_order_relaxed);
+    if (index == kEventsPerChunk)
+    {
+        if (t_Buffer->chunks == kMaxChunksPerThread)
+        {
+            t_Buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // Allowed to allocate, the chunk only exists because a trace was asked for
+        AllocPause pause;
+        EventChunk* grown = new EventChunk();
+        chunk->next.store(grown, std::memory_order_release);
+        t_Buffer->last = chunk = grown;
+        t_Buffer->chunks++;
+        index = 0;
+    }
+    chunk->events[index] = { name, detail, startNs, endNs };
+    chunk->count.store(index + 1, std::memory_order_release);
+}
+
+static void WriteJsonString(std::ostream& out, const char* text)
+{
+    out << '"';
+    for (const char* c = text; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            out << '\\';
+        out << *c;
+    }
+    out << '"';
+}
+
+bool CpuProfiler::WriteTrace(const std::string& path)
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "[Trace] Couldn't write " << path << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(s_BuffersMutex);
+    out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[\n";
+    bool first = true;
+    uint64_t events = 0;
+    uint64_t dropped = 0;
+    for (const std::unique_ptr<ThreadBuffer>& buffer : s_Buffers)
+    {
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+        WriteJsonString(out, buffer->name.c_str());
+        out << "}}";
+        first = false;
+
+        for (const EventChunk* chunk = buffer->first; chunk; chunk = chunk->next.load(std::memory_order_acquire))
+        {
+            uint32_t count = chunk->count.load(std::memory_order_acquire);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const ZoneEvent& e = chunk->events[i];
+                out << ",\n{\"name\":";
+                WriteJsonString(out, e.name);
+                out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                    << ",\"ts\":" << e.startNs / 1000.0 << ",\"dur\":" << (e.endNs - e.startNs) / 1000.0;
+                if (e.detail)
+                {
+                    out << ",\"args\":{\"detail\":";
+                    WriteJsonString(out, e.detail);
+                    out << "}";
+                }
+                out << "}";
+            }
+            events += count;
+        }
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    std::cout << "[Trace] " << events << " zones on " << s_Buffers.size() << " threads written to " << path;
+    if (dropped > 0)
+        std::cout << ", " << dropped << " dropped (a thread keeps at most " << kEventsPerChunk * kMaxChunksPerThread << ")";
+    std::cout << std::endl;
+    return true;
+}
+#endif
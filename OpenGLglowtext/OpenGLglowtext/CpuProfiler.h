@@ -0,0 +1,83 @@
+#pragma once
+#include <string>
+#include <cstdint>
+
+// Scoped CPU zones, written out as Chrome trace_event JSON (chrome://tracing,
+// ui.perfetto.dev). Every thread records into its own buffer without locks,
+// WriteTrace() picks up whatever has been published so far.
+// Release builds (NDEBUG) compile the zones out, NOTIFY_PROFILE keeps them.
+#if defined(NOTIFY_PROFILE) || !defined(NDEBUG)
+#define NOTIFY_PROFILE_ZONES 1
+#else
+#define NOTIFY_PROFILE_ZONES 0
+#endif
+
+class CpuProfiler
+{
+public:
+    // A thread's buffer grows a chunk at a time up to the limit, after that zones are dropped
+    static constexpr uint32_t kEventsPerChunk = 1 << 14;
+    static constexpr uint32_t kMaxChunksPerThread = 64;
+
+#if NOTIFY_PROFILE_ZONES
+    static constexpr bool kEnabled = true;
+
+    // Zones only record after this, a thread's buffer is allocated with its first zone
+    static void Start();
+    static bool IsRecording();
+
+    // Shown as the thread's name in the viewer
+    static void SetThreadName(const std::string& name);
+
+    // Usually at exit, once the recording threads are stopped
+    static bool WriteTrace(const std::string& path);
+
+    // ns since process start
+    static uint64_t Now();
+    // name and detail have to outlive the profiler (literals, manifest names)
+    static void Record(const char* name, const char* detail, uint64_t startNs, uint64_t endNs);
+#else
+    static constexpr bool kEnabled = false;
+
+    static void Start() {}
+    static bool IsRecording() { return false; }
+    static void SetThreadName(const std::string&) {}
+    static bool WriteTrace(const std::string&) { return false; }
+#endif
+};
+
+#if NOTIFY_PROFILE_ZONES
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const char* name, const char* detail = nullptr)
+        : m_Name(CpuProfiler::IsRecording() ? name : nullptr), m_Detail(detail)
+    {
+        if (m_Name)
+            m_Start = CpuProfiler::Now();
+    }
+    ~ProfileZone()
+    {
+        if (m_Name)
+            CpuProfiler::Record(m_Name, m_Detail, m_Start, CpuProfiler::Now());
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* m_Name;
+    const char* m_Detail;
+    uint64_t m_Start = 0;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+// Times the rest of the enclosing scope
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+// Same, with a second string shown as the event's argument (an asset name)
+#define PROFILE_ZONE_DETAIL(name, detail) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name, detail)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_ZONE_DETAIL(name, detail) ((void)0)
+#endif
@@ -0,0 +1,30 @@
+#include "Distribution.h"
+#include <algorithm>
+#include <cmath>
+
+Distribution Summarize(std::vector<float> values)
+{
+    Distribution d;
+    d.samples = values.size();
+    if (values.empty())
+        return d;
+
+    std::sort(values.begin(), values.end());
+    auto percentile = [&values](double p) { return values[std::max((size_t)std::ceil(values.size() * p), (size_t)1) - 1]; };
+    double sum = 0.0;
+    for (float v : values)
+        sum += v;
+    d.min = values.front();
+    d.avg = (float)(sum / values.size());
+    d.p50 = percentile(0.5);
+    d.p95 = percentile(0.95);
+    d.p99 = percentile(0.99);
+    d.max = values.back();
+    return d;
+}
+
+void WriteDistribution(std::ostream& out, const Distribution& d)
+{
+    out << "{ \"samples\": " << d.samples << ", \"min\": " << d.min << ", \"avg\": " << d.avg << ", \"p50\": " << d.p50
+        << ", \"p95\": " << d.p95 << ", \"p99\": " << d.p99 << ", \"max\": " << d.max << " }";
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <ostream>
+#include <vector>
+#include <cstddef>
+
+// Samples in ms, summarized
+struct Distribution
+{
+    size_t samples = 0;
+    float min = 0.0f, avg = 0.0f, p50 = 0.0f, p95 = 0.0f, p99 = 0.0f, max = 0.0f;
+};
+
+Distribution Summarize(std::vector<float> values);
+
+// As a JSON object, in the stream's number format
+void WriteDistribution(std::ostream& out, const Distribution& d);
@@ -0,0 +1,12 @@
+#include "FixedString.h"
+#include <atomic>
+#include <iostream>
+
+void WarnTextCut(std::string_view text, size_t kept)
+{
+    static std::atomic<bool> s_Warned = false;
+    if (s_Warned.exchange(true))
+        return;
+    std::cerr << "[Notify] Text cut off at " << kept << " of " << text.size() << " bytes: " << text.substr(0, kept)
+              << " (later ones aren't reported)" << std::endl;
+}
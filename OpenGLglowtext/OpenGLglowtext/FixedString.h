@@ -0,0 +1,54 @@
+#pragma once
+#include <string_view>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+// Prints the first text that had to be cut off, the later ones are only cut
+void WarnTextCut(std::string_view text, size_t kept);
+
+// Text stored inline, up to Capacity bytes of UTF-8 (longer input is cut
+// off before the code point that doesn't fit). Copying one never touches the
+// heap, so notifications and frame packets can carry their text through the
+// queue and the triple buffer for free.
+template <size_t Capacity>
+class FixedString
+{
+public:
+    FixedString() { m_Data[0] = '\0'; }
+    FixedString(const char* text) { Assign(text); }
+    FixedString(std::string_view text) { Assign(text); }
+
+    FixedString& operator=(const char* text) { Assign(text); return *this; }
+    FixedString& operator=(std::string_view text) { Assign(text); return *this; }
+
+    void Assign(std::string_view text)
+    {
+        m_Size = text.size();
+        if (m_Size > Capacity)
+        {
+            m_Size = Capacity;
+            while (m_Size > 0 && ((unsigned char)text[m_Size] & 0xC0) == 0x80)
+                m_Size--;
+            WarnTextCut(text, m_Size);
+        }
+        memcpy(m_Data, text.data(), m_Size);
+        m_Data[m_Size] = '\0';
+    }
+
+    size_t size() const { return m_Size; }
+    size_t length() const { return m_Size; }
+    bool empty() const { return m_Size == 0; }
+    const char* c_str() const { return m_Data; }
+    char operator[](size_t i) const { return m_Data[i]; }
+    const char* begin() const { return m_Data; }
+    const char* end() const { return m_Data + m_Size; }
+
+    operator std::string_view() const { return { m_Data, m_Size }; }
+
+    static constexpr size_t kCapacity = Capacity;
+
+private:
+    char m_Data[Capacity + 1];
+    size_t m_Size = 0;
+};
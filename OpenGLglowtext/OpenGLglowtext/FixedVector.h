@@ -0,0 +1,52 @@
+#pragma once
+#include <algorithm>
+#include <initializer_list>
+#include <span>
+#include <cstddef>
+
+// Up to Capacity items stored inline, the list counterpart of FixedString.
+// Items past the capacity are dropped.
+template <typename T, size_t Capacity>
+class FixedVector
+{
+public:
+    FixedVector() = default;
+    FixedVector(std::initializer_list<T> items)
+    {
+        for (const T& item : items)
+            push_back(item);
+    }
+
+    // False when full
+    bool push_back(const T& item)
+    {
+        if (m_Size == Capacity)
+            return false;
+        m_Items[m_Size++] = item;
+        return true;
+    }
+
+    // Replaces the items, the ones past the capacity are dropped
+    void assign(std::span<const T> items)
+    {
+        m_Size = std::min(items.size(), Capacity);
+        std::copy(items.begin(), items.begin() + m_Size, m_Items);
+    }
+
+    void clear() { m_Size = 0; }
+
+    size_t size() const { return m_Size; }
+    bool empty() const { return m_Size == 0; }
+    const T& operator[](size_t i) const { return m_Items[i]; }
+    const T* data() const { return m_Items; }
+    const T* begin() const { return m_Items; }
+    const T* end() const { return m_Items + m_Size; }
+
+    operator std::span<const T>() const { return { m_Items, m_Size }; }
+
+    static constexpr size_t kCapacity = Capacity;
+
+private:
+    T m_Items[Capacity] = {};
+    size_t m_Size = 0;
+};
@@ -0,0 +1,277 @@
+#include "FlightRecorder.h"
+#include "StartupReport.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+struct FlightMarker
+{
+    double startMs = 0.0;
+    float durationMs = -1.0f;
+    const char* kind = "";
+    char label[FlightRecorder::kLabelSize + 1] = {};
+};
+
+// What a snapshot holds, oldest first
+struct FlightSnapshot
+{
+    uint64_t triggerFrame = 0;
+    const char* reason = "";
+    float triggerMs = 0.0f;
+    FlightFrame frames[FlightRecorder::kFrames];
+    int frameCount = 0;
+    FlightMarker markers[FlightRecorder::kMarkers];
+    int markerCount = 0;
+};
+
+// Static storage, recording and taking a snapshot never allocate
+struct FlightState
+{
+    FlightConfig config;
+
+    // Render thread
+    FlightFrame frames[FlightRecorder::kFrames];
+    uint64_t frameCount = 0;
+    bool triggered = false;
+    uint64_t triggerFrame = 0;
+    const char* reason = "";
+    float triggerMs = 0.0f;
+    uint64_t snapshotAt = 0;
+    double lastSnapshotMs = -FlightRecorder::kCooldownMs;
+    uint64_t hitches = 0;
+    float worstMs = 0.0f;
+    uint64_t worstFrame = 0;
+    int snapshots = 0;
+
+    std::mutex markerMutex;
+    FlightMarker markers[FlightRecorder::kMarkers];
+    uint64_t markerCount = 0;
+
+    // Owned by the writer while set
+    std::atomic<bool> writing = false;
+    FlightSnapshot snapshot;
+    int written = 0;
+};
+
+static std::atomic<bool> s_Recording = false;
+static FlightState s_State;
+
+void FlightRecorder::Start(const FlightConfig& config)
+{
+    s_State.config = config;
+    s_State.frameCount = 0;
+    s_State.triggered = false;
+    s_State.lastSnapshotMs = -kCooldownMs;
+    s_State.hitches = 0;
+    s_State.worstMs = 0.0f;
+    s_State.snapshots = 0;
+    s_State.written = 0;
+    {
+        std::lock_guard<std::mutex> lock(s_State.markerMutex);
+        s_State.markerCount = 0;
+    }
+    s_Recording = config.budgetMs > 0.0f;
+}
+
+bool FlightRecorder::IsRecording()
+{
+    return s_Recording.load(std::memory_order_relaxed);
+}
+
+void FlightRecorder::Mark(const char* kind, std::string_view label, double startMs, double durationMs)
+{
+    if (!IsRecording())
+        return;
+
+    std::lock_guard<std::mutex> lock(s_State.markerMutex);
+    FlightMarker& marker = s_State.markers[s_State.markerCount++ % kMarkers];
+    marker.startMs = startMs;
+    marker.durationMs = (float)durationMs;
+    marker.kind = kind;
+    size_t size = std::min(label.size(), (size_t)kLabelSize);
+    memcpy(marker.label, label.data(), size);
+    marker.label[size] = '\0';
+}
+
+// Render thread. The first hitch after the cooldown is snapshotted, the others only counted.
+static void OnHitch(uint64_t frameIndex, double presentMs, const char* reason, float ms)
+{
+    FlightState& state = s_State;
+    state.hitches++;
+    if (ms > state.worstMs)
+    {
+        state.worstMs = ms;
+        state.worstFrame = frameIndex;
+    }
+    if (state.triggered || state.snapshots >= FlightRecorder::kMaxSnapshots || presentMs - state.lastSnapshotMs < FlightRecorder::kCooldownMs)
+        return;
+
+    state.triggered = true;
+    state.triggerFrame = frameIndex;
+    state.reason = reason;
+    state.triggerMs = ms;
+    state.snapshotAt = frameIndex + FlightRecorder::kTrailingFrames;
+}
+
+// Render thread
+static void TakeSnapshot(double presentMs)
+{
+    FlightState& state = s_State;
+    FlightSnapshot& snapshot = state.snapshot;
+    snapshot.triggerFrame = state.triggerFrame;
+    snapshot.reason = state.reason;
+    snapshot.triggerMs = state.triggerMs;
+
+    uint64_t frames = std::min<uint64_t>(state.frameCount, FlightRecorder::kFrames);
+    for (uint64_t i = 0; i < frames; i++)
+        snapshot.frames[i] = state.frames[(state.frameCount - frames + i) % FlightRecorder::kFrames];
+    snapshot.frameCount = (int)frames;
+
+    {
+        std::lock_guard<std::mutex> lock(state.markerMutex);
+        uint64_t markers = std::min<uint64_t>(state.markerCount, FlightRecorder::kMarkers);
+        for (uint64_t i = 0; i < markers; i++)
+            snapshot.markers[i] = state.markers[(state.markerCount - markers + i) % FlightRecorder::kMarkers];
+        snapshot.markerCount = (int)markers;
+    }
+
+    state.triggered = false;
+    state.snapshots++;
+    state.lastSnapshotMs = presentMs;
+}
+
+bool FlightRecorder::AddFrame(const FlightFrame& frame)
+{
+    if (!IsRecording())
+        return false;
+
+    FlightState& state = s_State;
+    state.frames[state.frameCount++ % kFrames] = frame;
+
+    float budget = state.config.budgetMs;
+    if (frame.intervalMs > budget)
+        OnHitch(frame.index, frame.presentMs, "interval", frame.intervalMs);
+    else if (frame.renderMs > budget)
+        OnHitch(frame.index, frame.presentMs, "render", frame.renderMs);
+    else if (frame.simMs > budget)
+        OnHitch(frame.index, frame.presentMs, "simulation", frame.simMs);
+
+    // A snapshot still being written holds the next one back
+    if (!state.triggered || frame.index < state.snapshotAt || state.writing.load())
+        return false;
+    TakeSnapshot(frame.presentMs);
+    state.writing = true;
+    return true;
+}
+
+void FlightRecorder::AddGpuTime(uint64_t frameIndex, float gpuMs)
+{
+    if (!IsRecording() || gpuMs < 0.0f)
+        return;
+
+    // Dropped packets leave gaps in the indices, look back from the newest
+    FlightState& state = s_State;
+    uint64_t frames = std::min<uint64_t>(state.frameCount, kTrailingFrames * 2);
+    for (uint64_t i = 1; i <= frames; i++)
+    {
+        FlightFrame& frame = state.frames[(state.frameCount - i) % kFrames];
+        if (frame.index != frameIndex)
+            continue;
+        frame.gpuMs = gpuMs;
+        if (gpuMs > state.config.budgetMs)
+            OnHitch(frameIndex, frame.presentMs, "gpu", gpuMs);
+        return;
+    }
+}
+
+// Notification text is whatever the caller sent
+static void WriteJsonString(std::ostream& out, const char* text)
+{
+    out << '"';
+    for (const char* c = text; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            out << '\\' << *c;
+        else if ((unsigned char)*c < 0x20)
+            out << ' ';
+        else
+            out << *c;
+    }
+    out << '"';
+}
+
+void FlightRecorder::WriteSnapshot()
+{
+    FlightState& state = s_State;
+    const FlightSnapshot& snapshot = state.snapshot;
+
+    std::error_code error;
+    std::filesystem::create_directories(state.config.dir, error);
+    std::string path = state.config.dir + "/hitch_" + std::to_string(snapshot.triggerFrame) + ".json";
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "[Hitch] Couldn't write " << path << std::endl;
+        state.writing = false;
+        return;
+    }
+
+    out << std::fixed << std::setprecision(3)
+        << "{\n  \"budget_ms\": " << state.config.budgetMs << ",\n  \"trigger\": { \"frame\": " << snapshot.triggerFrame
+        << ", \"reason\": \"" << snapshot.reason << "\", \"ms\": " << snapshot.triggerMs << " },\n  \"frames\": [";
+    for (int i = 0; i < snapshot.frameCount; i++)
+    {
+        const FlightFrame& frame = snapshot.frames[i];
+        out << (i ? ",\n" : "\n") << "    { \"frame\": " << frame.index << ", \"present_ms\": " << frame.presentMs
+            << ", \"interval_ms\": " << frame.intervalMs << ", \"render_ms\": " << frame.renderMs << ", \"sim_ms\": " << frame.simMs
+            << ", \"gpu_ms\": " << frame.gpuMs << ", \"scenario\": \"" << frame.scenario << "\" }";
+    }
+    out << "\n  ],\n  \"markers\": [";
+    for (int i = 0; i < snapshot.markerCount; i++)
+    {
+        const FlightMarker& marker = snapshot.markers[i];
+        out << (i ? ",\n" : "\n") << "    { \"kind\": \"" << marker.kind << "\", \"label\": ";
+        WriteJsonString(out, marker.label);
+        out << ", \"start_ms\": " << marker.startMs;
+        if (marker.durationMs >= 0.0f)
+            out << ", \"ms\": " << marker.durationMs;
+        out << " }";
+    }
+    out << "\n  ]\n}\n";
+    out.close();
+
+    std::cout << std::fixed << std::setprecision(1) << "[Hitch] Frame " << snapshot.triggerFrame << " took " << snapshot.triggerMs << " ms ("
+              << snapshot.reason << "), the last " << snapshot.frameCount << " frames written to " << path << std::endl;
+    state.written++;
+    state.writing = false;
+}
+
+void FlightRecorder::PrintReport(std::ostream& out)
+{
+    if (!IsRecording())
+        return;
+
+    const FlightState& state = s_State;
+    out << std::fixed << std::setprecision(1) << "[Hitch] " << state.hitches << " frames over " << state.config.budgetMs << " ms";
+    if (state.hitches > 0)
+        out << ", worst " << state.worstMs << " ms (frame " << state.worstFrame << "), " << state.written << " snapshots in " << state.config.dir;
+    out << std::endl;
+}
+
+FlightMark::FlightMark(const char* kind, std::string_view label)
+    : m_Kind(FlightRecorder::IsRecording() ? kind : nullptr), m_Label(label)
+{
+    if (m_Kind)
+        m_Start = StartupReport::Now();
+}
+
+FlightMark::~FlightMark()
+{
+    if (m_Kind)
+        FlightRecorder::Mark(m_Kind, m_Label, m_Start, StartupReport::Now() - m_Start);
+}
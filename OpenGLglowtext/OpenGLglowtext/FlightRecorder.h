@@ -0,0 +1,79 @@
+#pragma once
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+// What the hitch recorder keeps an eye on
+struct FlightConfig
+{
+    float budgetMs = 50.0f;         // --hitch-budget <ms>: a frame over it is a hitch, 0 turns the recorder off
+    std::string dir = "hitches";    // --hitch-dir <folder>: where the snapshots go
+};
+
+// One presented frame. Times in ms, presentMs since process start like the markers.
+struct FlightFrame
+{
+    uint64_t index = 0;
+    double presentMs = 0.0;
+    float intervalMs = 0.0f;    // since the previous present, 0 for the first frame
+    float renderMs = 0.0f;      // RenderFrame start to present
+    float simMs = 0.0f;         // the simulation tick that published the frame
+    float gpuMs = -1.0f;        // added once the GPU timer has it, -1 without
+    const char* scenario = "";  // literal
+};
+
+// Always on flight recorder for hitches. Keeps the last kFrames frame
+// timings and the last kMarkers events (notifications, font and sound
+// loads, shader compiles, icon uploads...) in fixed rings. A frame over the
+// budget takes a snapshot of both kTrailingFrames frames later, so the
+// hitch's GPU time and the frames after it are in, and WriteSnapshot()
+// writes it to JSON off the render thread. Recording a frame takes no lock
+// and never allocates, a marker takes a short lock.
+class FlightRecorder
+{
+public:
+    static constexpr int kFrames = 300;
+    static constexpr int kMarkers = 256;
+    static constexpr int kLabelSize = 48;
+    static constexpr int kTrailingFrames = 8;
+    static constexpr int kMaxSnapshots = 8;         // per run
+    static constexpr double kCooldownMs = 10000.0;  // at least this between two snapshots
+
+    // Clears the rings and starts recording
+    static void Start(const FlightConfig& config);
+    static bool IsRecording();
+
+    // Any thread. kind is a literal, label is copied (cut at kLabelSize).
+    // durationMs < 0 for an event without a duration.
+    static void Mark(const char* kind, std::string_view label, double startMs, double durationMs = -1.0);
+
+    // Render thread, once per presented frame. True when a snapshot was
+    // taken and waits for WriteSnapshot().
+    static bool AddFrame(const FlightFrame& frame);
+    // Render thread. GPU time of an earlier frame, still in the ring.
+    static void AddGpuTime(uint64_t frameIndex, float gpuMs);
+
+    // Any thread, after AddFrame() returned true
+    static void WriteSnapshot();
+
+    // Once the render thread stopped
+    static void PrintReport(std::ostream& out);
+};
+
+// Marks the rest of the enclosing scope with its duration. label has to
+// live until the end of the scope.
+class FlightMark
+{
+public:
+    FlightMark(const char* kind, std::string_view label);
+    ~FlightMark();
+
+    FlightMark(const FlightMark&) = delete;
+    FlightMark& operator=(const FlightMark&) = delete;
+
+private:
+    const char* m_Kind;
+    std::string_view m_Label;
+    double m_Start = 0.0;
+};
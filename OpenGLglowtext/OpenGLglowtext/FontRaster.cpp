@@ -0,0 +1,102 @@
+#include "FontRaster.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+// CPU only, safe to run on any thread (every call uses its own FT_Library)
+std::vector<GlyphBitmap> RasterizeFont(const unsigned char* data, size_t size, int pixelSize)
+{
+    std::vector<GlyphBitmap> glyphs;
+
+    FT_Library ft;
+    FT_Init_FreeType(&ft);
+
+    FT_Face face;
+    if (FT_New_Memory_Face(ft, data, (FT_Long)size, 0, &face))
+    {
+        std::cerr << "[Font] Not a font file FreeType can read" << std::endl;
+        FT_Done_FreeType(ft);
+        return glyphs;
+    }
+    FT_Set_Pixel_Sizes(face, 0, pixelSize); // face, pixel_width, pixel_height
+
+    glyphs.reserve(128 - 32);
+    for (unsigned char c = 32; c < 128; c++)
+    {
+        FT_Load_Char(face, c, FT_LOAD_RENDER);
+        FT_GlyphSlot slot = face->glyph;
+
+        GlyphBitmap& glyph = glyphs.emplace_back();
+        glyph.code    = c;
+        glyph.width   = slot->bitmap.width;
+        glyph.rows    = slot->bitmap.rows;
+        glyph.left    = slot->bitmap_left;
+        glyph.top     = slot->bitmap_top;
+        glyph.advance = slot->advance.x;
+
+        // Copy row by row, the FreeType buffer is only valid until the next load
+        glyph.pixels.resize((size_t)glyph.width * glyph.rows);
+        for (unsigned int row = 0; row < glyph.rows; row++)
+        {
+            memcpy(glyph.pixels.data() + (size_t)row * glyph.width,
+                slot->bitmap.buffer + (size_t)row * slot->bitmap.pitch,
+                glyph.width);
+        }
+    }
+    FT_Done_Face(face);
+    FT_Done_FreeType(ft);
+    return glyphs;
+}
+
+TextureData BuildGlyphAtlas(const std::vector<GlyphBitmap>& glyphs)
+{
+    TextureData atlas;
+    atlas.format = TexFormat::R8;
+    atlas.layers = 0;
+
+    int cellW = 4;
+    int cellH = 4;
+    for (const GlyphBitmap& glyph : glyphs)
+    {
+        if (glyph.width == 0 || glyph.rows == 0)
+            continue;
+        cellW = std::max(cellW, (int)glyph.width + kGlyphMargin * 2);
+        cellH = std::max(cellH, (int)glyph.rows + kGlyphMargin * 2);
+        atlas.layers++;
+    }
+    atlas.width = (cellW + 3) & ~3;
+    atlas.height = (cellH + 3) & ~3;
+
+    // Zero filled, the margins must read as transparent
+    atlas.pixels.assign(TexTotalSize(atlas), 0);
+
+    int layer = 0;
+    for (const GlyphBitmap& glyph : glyphs)
+    {
+        TexGlyph& entry = atlas.glyphs.emplace_back();
+        entry.code    = glyph.code;
+        entry.layer   = -1;
+        entry.width   = glyph.width;
+        entry.height  = glyph.rows;
+        entry.left    = glyph.left;
+        entry.top     = glyph.top;
+        entry.advance = (int32_t)glyph.advance;
+
+        if (glyph.width == 0 || glyph.rows == 0)
+            continue;
+
+        entry.layer = layer;
+        unsigned char* cell = atlas.pixels.data() + TexLevelOffset(atlas, 0, layer);
+        for (unsigned int row = 0; row < glyph.rows; row++)
+        {
+            memcpy(cell + (size_t)(row + kGlyphMargin) * atlas.width + kGlyphMargin,
+                glyph.pixels.data() + (size_t)row * glyph.width,
+                glyph.width);
+        }
+        layer++;
+    }
+    return atlas;
+}
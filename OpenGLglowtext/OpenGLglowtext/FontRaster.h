@@ -0,0 +1,30 @@
+#pragma once
+#include "TextureFile.h"
+#include <string>
+#include <vector>
+
+// Every font is rasterized at this size, text scale is applied on the quads
+static constexpr int kFontPixelSize = 48;
+
+// Margin in texels between a glyph and its cell border
+static constexpr int kGlyphMargin = 2;
+
+struct GlyphBitmap
+{
+    unsigned char code;
+    unsigned int width;
+    unsigned int rows;
+    int left;
+    int top;
+    long advance;
+    std::vector<unsigned char> pixels;
+};
+
+// CPU only, safe to run on any thread (every call uses its own FT_Library).
+// FreeType reads the font file in place, data only has to live for the call.
+std::vector<GlyphBitmap> RasterizeFont(const unsigned char* data, size_t size, int pixelSize);
+
+// One glyph per layer of an R8 atlas. The cells leave an empty margin around
+// every glyph and are rounded up to whole 4x4 blocks, so the same layout
+// can be block compressed offline.
+TextureData BuildGlyphAtlas(const std::vector<GlyphBitmap>& glyphs);
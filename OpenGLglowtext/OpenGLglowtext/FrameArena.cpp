@@ -0,0 +1,47 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <iostream>
+#include <cstdint>
+
+FrameArena::FrameArena(size_t capacity)
+    : m_Block(new unsigned char[capacity]), m_Capacity(capacity)
+{
+    m_Overflow.reserve(16);
+}
+
+FrameArena::~FrameArena()
+{
+    Reset();
+    delete[] m_Block;
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+    uintptr_t base = (uintptr_t)m_Block;
+    size_t offset = ((base + m_Offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+    if (offset + size <= m_Capacity)
+    {
+        m_Offset = offset + size;
+        m_Peak = std::max(m_Peak, m_Offset);
+        return m_Block + offset;
+    }
+
+    if (!m_Warned)
+    {
+        std::cerr << "[Arena] " << size << " bytes don't fit the frame arena (" << m_Capacity
+                  << " bytes), falling back to the heap" << std::endl;
+        m_Warned = true;
+    }
+    unsigned char* overflow = new unsigned char[size + alignment];
+    m_Overflow.push_back(overflow);
+    uintptr_t aligned = ((uintptr_t)overflow + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    return (void*)aligned;
+}
+
+void FrameArena::Reset()
+{
+    for (unsigned char* overflow : m_Overflow)
+        delete[] overflow;
+    m_Overflow.clear();
+    m_Offset = 0;
+}
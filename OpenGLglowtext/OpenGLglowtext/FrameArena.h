@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <cstddef>
+#include <type_traits>
+#include <new>
+
+// Linear allocator for data that only lives for one simulation tick (cue
+// lists, shuffle tables). The block is allocated once, Allocate() bumps an
+// offset and Reset() at the start of the next tick hands everything back
+// at once. Only trivially destructible types, nothing is destroyed.
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t capacity);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Falls back to the heap when the block is full (warns once), the
+    // overflow is freed by the next Reset()
+    void* Allocate(size_t size, size_t alignment);
+
+    template <typename T>
+    std::span<T> AllocArray(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "the arena never runs destructors");
+        T* items = (T*)Allocate(sizeof(T) * count, alignof(T));
+        for (size_t i = 0; i < count; i++)
+            new (&items[i]) T();
+        return { items, count };
+    }
+
+    void Reset();
+
+    size_t GetCapacity() const { return m_Capacity; }
+    size_t GetPeak() const { return m_Peak; }
+
+private:
+    unsigned char* m_Block;
+    size_t m_Capacity;
+    size_t m_Offset = 0;
+    size_t m_Peak = 0;
+    bool m_Warned = false;
+    std::vector<unsigned char*> m_Overflow;
+};
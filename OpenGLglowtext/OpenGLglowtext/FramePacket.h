@@ -0,0 +1,87 @@
+#pragma once
+#include "AudioCues.h"
+#include "TextureLoader.h"
+#include "NotifyStyle.h"
+#include "FixedString.h"
+#include "FixedVector.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// Inline text of notifications and packets, longer text is cut off
+using NotifyText = FixedString<63>;
+using NotifyDescription = FixedString<127>;
+
+struct DecayEntry
+{
+    int index;
+    float startTime;
+};
+
+struct PulseTextFX
+{
+    NotifyText text;
+    float birthTime;
+    float letterDelay = 0.08f;
+    float pulseSpeed = 6.0f;
+    float holdTime = 2.0f;
+    float decayDuration = 1.0f;
+    bool active = false;
+};
+
+enum class NotifyState
+{
+    None,
+    Splash,
+    Pulse
+};
+
+// Text measurements of one notification at scale 1. Filled by a context job
+// once its fonts are resident, so only the render thread touches it.
+struct SplashLayout
+{
+    bool ready = false;
+    glm::vec2 titleSize = glm::vec2(0.0f);   // title font, centers the title
+    glm::vec2 anchorSize = glm::vec2(0.0f);  // "default", places the icon and description
+    float descWidth = 0.0f;                  // "default", color codes skipped
+};
+
+// Everything the render thread needs to draw a splash / killstreak,
+// already resolved by the simulation side (animation values, type, icon).
+struct SplashDrawData
+{
+    NotifyText  text;
+    NotifyDescription description;
+    IconId      icon = IconId::None;
+    glm::vec3   color = glm::vec3(1.0f);
+    NotifyStyle style;
+    float       textScale = 1.0f;
+    double      scale = 1.0;
+    double      alpha = 0.0;
+    double      x = 0.0;
+    std::shared_ptr<const SplashLayout> layout;  // measured on the spot when null or not ready
+    uint32_t    id = 0;                          // NotifyData::id
+};
+
+// Immutable snapshot of one simulated frame. The simulation thread fills it,
+// the render thread only reads it.
+struct FramePacket
+{
+    uint64_t frameIndex = 0;
+    double time = 0.0;
+    float simMs = 0.0f;     // the tick that filled it, for the hitch recorder
+
+    NotifyState state = NotifyState::None;
+    bool drawSplash = false;
+    SplashDrawData splash;
+
+    NotifyText glowText;
+
+    bool drawPulseText = false;
+    PulseTextFX pulseText;
+    FixedVector<DecayEntry, NotifyText::kCapacity> decayOrder;  // one entry per char of pulseText
+
+    CueMarkers cueMarkers;
+};
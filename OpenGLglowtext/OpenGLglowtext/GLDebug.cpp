@@ -0,0 +1,204 @@
+#include "GLDebug.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <string>
+
+static const char* const kModeNames[] = { "off", "async", "sync" };
+
+struct DebugMessage
+{
+    GLenum source;
+    GLenum type;
+    GLuint id;
+    GLenum severity;
+    const char* site;   // GL_CHECK label, null for driver messages
+    uint64_t count;
+    char text[GLDebug::kMessageSize + 1];
+};
+
+static std::mutex s_Mutex;
+static DebugMessage s_Messages[GLDebug::kMaxMessages];
+static int s_MessageCount = 0;
+static uint64_t s_Unlisted = 0;     // duplicates of messages that didn't fit
+static std::atomic<GLDebugMode> s_Mode = GLDebugMode::Off;
+
+const char* GetDebugModeName(GLDebugMode mode)
+{
+    return kModeNames[(int)mode];
+}
+
+bool DebugModeFromName(std::string_view name, GLDebugMode& mode)
+{
+    for (int i = 0; i < (int)std::size(kModeNames); i++)
+    {
+        if (name == kModeNames[i])
+        {
+            mode = (GLDebugMode)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static const char* GetSeverityName(GLenum severity)
+{
+    switch (severity)
+    {
+        case GL_DEBUG_SEVERITY_HIGH: return "high";
+        case GL_DEBUG_SEVERITY_MEDIUM: return "medium";
+        case GL_DEBUG_SEVERITY_LOW: return "low";
+        default: return "notification";
+    }
+}
+
+static const char* GetTypeName(GLenum type)
+{
+    switch (type)
+    {
+        case GL_DEBUG_TYPE_ERROR: return "error";
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated";
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "undefined behavior";
+        case GL_DEBUG_TYPE_PORTABILITY: return "portability";
+        case GL_DEBUG_TYPE_PERFORMANCE: return "performance";
+        case GL_DEBUG_TYPE_MARKER: return "marker";
+        default: return "other";
+    }
+}
+
+static const char* GetErrorName(GLenum error)
+{
+    switch (error)
+    {
+        case GL_INVALID_ENUM: return "GL_INVALID_ENUM";
+        case GL_INVALID_VALUE: return "GL_INVALID_VALUE";
+        case GL_INVALID_OPERATION: return "GL_INVALID_OPERATION";
+        case GL_INVALID_FRAMEBUFFER_OPERATION: return "GL_INVALID_FRAMEBUFFER_OPERATION";
+        case GL_OUT_OF_MEMORY: return "GL_OUT_OF_MEMORY";
+        case GL_STACK_UNDERFLOW: return "GL_STACK_UNDERFLOW";
+        case GL_STACK_OVERFLOW: return "GL_STACK_OVERFLOW";
+        default: return "unknown GL error";
+    }
+}
+
+// Counts the message, the first of its kind is printed unless it's only a notification
+static void AddMessage(GLenum source, GLenum type, GLuint id, GLenum severity, const char* site, std::string_view text)
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    for (int i = 0; i < s_MessageCount; i++)
+    {
+        DebugMessage& message = s_Messages[i];
+        if (message.id == id && message.source == source && message.type == type && message.severity == severity && message.site == site)
+        {
+            message.count++;
+            return;
+        }
+    }
+    if (s_MessageCount == GLDebug::kMaxMessages)
+    {
+        s_Unlisted++;
+        return;
+    }
+
+    DebugMessage& message = s_Messages[s_MessageCount++];
+    message = { source, type, id, severity, site, 1, {} };
+    size_t size = std::min(text.size(), (size_t)GLDebug::kMessageSize);
+    memcpy(message.text, text.data(), size);
+    message.text[size] = '\0';
+    if (severity != GL_DEBUG_SEVERITY_NOTIFICATION)
+        std::cerr << "[GL] " << GetSeverityName(severity) << " " << GetTypeName(type) << " " << id << ": " << message.text << std::endl;
+}
+
+static void APIENTRY OpenGLDebugCallback(
+    GLenum source,
+    GLenum type,
+    GLuint id,
+    GLenum severity,
+    GLsizei length,
+    const GLchar* message,
+    const void* /*userParam*/)
+{
+    AddMessage(source, type, id, severity, nullptr, length >= 0 ? std::string_view(message, length) : std::string_view(message));
+}
+
+void GLDebug::Install(GLDebugMode mode)
+{
+    {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        s_MessageCount = 0;
+        s_Unlisted = 0;
+    }
+    glDebugMessageCallback(OpenGLDebugCallback, nullptr);
+    SetMode(mode);
+}
+
+void GLDebug::SetMode(GLDebugMode mode)
+{
+    // A debug context starts with the output on
+    if (mode == GLDebugMode::Off)
+        glDisable(GL_DEBUG_OUTPUT);
+    else
+        glEnable(GL_DEBUG_OUTPUT);
+    if (mode == GLDebugMode::Sync)
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    else
+        glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    s_Mode = mode;
+}
+
+GLDebugMode GLDebug::GetMode()
+{
+    return s_Mode;
+}
+
+void GLDebug::CheckErrors(const char* label, const char* file, int line)
+{
+    // A lost context can keep reporting, a few are enough
+    for (int i = 0; i < 8; i++)
+    {
+        GLenum error = glGetError();
+        if (error == GL_NO_ERROR)
+            return;
+        std::string text = std::string(GetErrorName(error)) + " after " + label + " (" + file + ":" + std::to_string(line) + ")";
+        AddMessage(GL_DEBUG_SOURCE_API, GL_DEBUG_TYPE_ERROR, error, GL_DEBUG_SEVERITY_HIGH, label, text);
+    }
+}
+
+void GLDebug::PrintReport(std::ostream& out)
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    if (s_Mode == GLDebugMode::Off && s_MessageCount == 0)
+        return;
+
+    // Totals by severity, then every distinct message, the most frequent first
+    static const GLenum kSeverities[] = { GL_DEBUG_SEVERITY_HIGH, GL_DEBUG_SEVERITY_MEDIUM, GL_DEBUG_SEVERITY_LOW, GL_DEBUG_SEVERITY_NOTIFICATION };
+    out << "[GL] debug output " << GetDebugModeName(s_Mode) << ":";
+    for (GLenum severity : kSeverities)
+    {
+        uint64_t total = 0;
+        for (int i = 0; i < s_MessageCount; i++)
+        {
+            if (s_Messages[i].severity == severity)
+                total += s_Messages[i].count;
+        }
+        out << " " << total << " " << GetSeverityName(severity) << (severity == kSeverities[3] ? "" : ",");
+    }
+    out << " (" << s_MessageCount << " distinct";
+    if (s_Unlisted > 0)
+        out << ", " << s_Unlisted << " more not listed";
+    out << ")" << std::endl;
+
+    DebugMessage* sorted[kMaxMessages];
+    for (int i = 0; i < s_MessageCount; i++)
+        sorted[i] = &s_Messages[i];
+    std::sort(sorted, sorted + s_MessageCount, [](const DebugMessage* a, const DebugMessage* b) { return a->count > b->count; });
+    for (int i = 0; i < s_MessageCount; i++)
+    {
+        const DebugMessage& message = *sorted[i];
+        out << "[GL]   " << message.count << "x " << GetSeverityName(message.severity) << " " << GetTypeName(message.type)
+            << " " << message.id << ": " << message.text << std::endl;
+    }
+}
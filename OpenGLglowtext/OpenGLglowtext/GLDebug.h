@@ -0,0 +1,60 @@
+#pragma once
+#include <glad/glad.h>
+#include <ostream>
+#include <string_view>
+#include <cstdint>
+
+// Builds without NDEBUG check glGetError after GL_CHECK(), NOTIFY_GL_CHECK
+// keeps the checks in a release build
+#if defined(NOTIFY_GL_CHECK) || !defined(NDEBUG)
+#define NOTIFY_GL_CHECKS 1
+#else
+#define NOTIFY_GL_CHECKS 0
+#endif
+
+enum class GLDebugMode
+{
+    Off,    // no debug context, no messages
+    Async,  // messages whenever the driver gets to them, the calls aren't serialized
+    Sync    // every message on the thread of the call that caused it, slow, for breakpoints
+};
+
+const char* GetDebugModeName(GLDebugMode mode);
+bool DebugModeFromName(std::string_view name, GLDebugMode& mode);
+
+// Driver messages of the debug context, aggregated. Duplicates (same
+// source, type, id and severity) only bump a counter, the first of each is
+// printed unless it is a notification. The callback may run on a driver
+// thread in async mode, the table is fixed and guarded by a lock.
+class GLDebug
+{
+public:
+    static constexpr int kMaxMessages = 64;     // distinct ones, later ones are only counted
+    static constexpr int kMessageSize = 159;    // the text kept of each, longer is cut
+
+    // Debug builds listen asynchronously, release builds don't
+#ifdef NDEBUG
+    static constexpr GLDebugMode kDefaultMode = GLDebugMode::Off;
+#else
+    static constexpr GLDebugMode kDefaultMode = GLDebugMode::Async;
+#endif
+
+    // Context thread, once the functions are loaded. Installs the callback
+    // and clears the counters.
+    static void Install(GLDebugMode mode);
+    // Context thread, switches the running context
+    static void SetMode(GLDebugMode mode);
+    static GLDebugMode GetMode();
+
+    // Reports what glGetError has, label says after what. GL_CHECK calls it.
+    static void CheckErrors(const char* label, const char* file, int line);
+
+    static void PrintReport(std::ostream& out);
+};
+
+#if NOTIFY_GL_CHECKS
+// Reports any GL error raised so far, label (a literal) names what ran before
+#define GL_CHECK(label) GLDebug::CheckErrors(label, __FILE__, __LINE__)
+#else
+#define GL_CHECK(label) ((void)0)
+#endif
@@ -0,0 +1,224 @@
+#include "GpuTimer.h"
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+GpuTimer::GpuTimer()
+{
+    for (FrameSlot& slot : m_Slots)
+        glCreateQueries(GL_TIMESTAMP, kMaxScopesPerFrame * 2, slot.queries);
+}
+
+GpuTimer::~GpuTimer()
+{
+    for (FrameSlot& slot : m_Slots)
+        glDeleteQueries(kMaxScopesPerFrame * 2, slot.queries);
+}
+
+void GpuTimer::BeginFrame()
+{
+    FrameSlot& slot = m_Slots[m_Slot];
+    m_CollectedFrameMs = -1.0f;
+    if (slot.pending)
+        Collect(slot);
+
+    slot.queryCount = 0;
+    slot.scopeCount = 0;
+    slot.pending = false;
+    m_Depth = 0;
+    m_Overflow = 0;
+    m_InFrame = true;
+    Begin("frame");
+}
+
+void GpuTimer::EndFrame()
+{
+    if (!m_InFrame)
+        return;
+
+    // Closes whatever a pass left open, then the frame scope
+    while (m_Depth > 0)
+        End();
+
+    FrameSlot& slot = m_Slots[m_Slot];
+    slot.pending = slot.scopeCount > 0;
+    m_Slot = (m_Slot + 1) % kFramesInFlight;
+    m_InFrame = false;
+}
+
+void GpuTimer::Begin(const char* name)
+{
+    if (!m_InFrame)
+        return;
+
+    FrameSlot& slot = m_Slots[m_Slot];
+    int pass = FindPass(name);
+    if (pass < 0 || slot.scopeCount == kMaxScopesPerFrame || m_Depth == kMaxDepth)
+    {
+        if (!m_Warned)
+            std::cerr << "[GpuTime] Out of passes, scopes or depth, '" << name << "' isn't timed" << std::endl;
+        m_Warned = true;
+        // Still counted so End() stays balanced
+        if (m_Depth < kMaxDepth)
+            m_Open[m_Depth++] = -1;
+        else
+            m_Overflow++;
+        return;
+    }
+
+    Scope& scope = slot.scopes[slot.scopeCount];
+    scope.pass = pass;
+    scope.beginQuery = slot.queryCount++;
+    scope.endQuery = -1;
+    glQueryCounter(slot.queries[scope.beginQuery], GL_TIMESTAMP);
+    m_Open[m_Depth++] = slot.scopeCount++;
+}
+
+void GpuTimer::End()
+{
+    if (!m_InFrame || m_Depth == 0)
+        return;
+    if (m_Overflow > 0)
+    {
+        m_Overflow--;
+        return;
+    }
+
+    int open = m_Open[--m_Depth];
+    if (open < 0)
+        return;
+
+    FrameSlot& slot = m_Slots[m_Slot];
+    Scope& scope = slot.scopes[open];
+    scope.endQuery = slot.queryCount++;
+    glQueryCounter(slot.queries[scope.endQuery], GL_TIMESTAMP);
+}
+
+int GpuTimer::FindPass(const char* name)
+{
+    for (int i = 0; i < m_PassCount; i++)
+    {
+        if (m_Passes[i].name == name || strcmp(m_Passes[i].name, name) == 0)
+            return i;
+    }
+    if (m_PassCount == kMaxPasses)
+        return -1;
+
+    m_Passes[m_PassCount].name = name;
+    return m_PassCount++;
+}
+
+void GpuTimer::Collect(FrameSlot& slot)
+{
+    // Timestamps land in submission order, the last one being there means the whole frame is
+    GLint available = 0;
+    glGetQueryObjectiv(slot.queries[slot.queryCount - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+    {
+        m_MissedFrames++;
+        return;
+    }
+
+    GLuint64 times[kMaxScopesPerFrame * 2];
+    for (int i = 0; i < slot.queryCount; i++)
+        glGetQueryObjectui64v(slot.queries[i], GL_QUERY_RESULT, &times[i]);
+
+    float frameMs[kMaxPasses];
+    std::fill(frameMs, frameMs + m_PassCount, -1.0f);
+    for (int i = 0; i < slot.scopeCount; i++)
+    {
+        const Scope& scope = slot.scopes[i];
+        float ms = (float)((double)(times[scope.endQuery] - times[scope.beginQuery]) / 1.0e6);
+        frameMs[scope.pass] = std::max(frameMs[scope.pass], 0.0f) + ms;
+    }
+
+    // The frame scope is always the first pass
+    m_CollectedFrameMs = frameMs[0];
+    for (int i = 0; i < m_PassCount; i++)
+    {
+        if (frameMs[i] < 0.0f)
+            continue;
+        PassHistory& pass = m_Passes[i];
+        pass.samples[pass.next] = frameMs[i];
+        pass.next = (pass.next + 1) % kHistory;
+        pass.count = std::min(pass.count + 1, kHistory);
+    }
+}
+
+GpuPassStats GpuTimer::ComputeStats(const PassHistory& pass) const
+{
+    GpuPassStats stats;
+    stats.name = pass.name;
+    stats.samples = (uint32_t)pass.count;
+    if (pass.count == 0)
+        return stats;
+
+    float sorted[kHistory];
+    std::copy(pass.samples, pass.samples + pass.count, sorted);
+
+    float sum = 0.0f;
+    stats.minMs = sorted[0];
+    for (int i = 0; i < pass.count; i++)
+    {
+        sum += sorted[i];
+        stats.minMs = std::min(stats.minMs, sorted[i]);
+    }
+    stats.avgMs = sum / pass.count;
+
+    int p99 = std::max((int)std::ceil(pass.count * 0.99) - 1, 0);
+    std::nth_element(sorted, sorted + p99, sorted + pass.count);
+    stats.p99Ms = sorted[p99];
+    return stats;
+}
+
+size_t GpuTimer::GetStats(std::span<GpuPassStats> out) const
+{
+    size_t count = std::min(out.size(), (size_t)m_PassCount);
+    for (size_t i = 0; i < count; i++)
+        out[i] = ComputeStats(m_Passes[i]);
+    return count;
+}
+
+void GpuTimer::WriteCsv(std::ostream& out, double time, bool header) const
+{
+    if (header)
+        out << "time_s,pass,samples,min_ms,avg_ms,p99_ms\n";
+
+    out << std::fixed;
+    for (int i = 0; i < m_PassCount; i++)
+    {
+        GpuPassStats stats = ComputeStats(m_Passes[i]);
+        out << std::setprecision(2) << time << ',' << stats.name << ',' << stats.samples << ','
+            << std::setprecision(4) << stats.minMs << ',' << stats.avgMs << ',' << stats.p99Ms << '\n';
+    }
+    out.flush();
+}
+
+void GpuTimer::WriteJson(std::ostream& out, double time) const
+{
+    out << std::fixed << std::setprecision(4)
+        << "{\n  \"time_s\": " << time << ",\n  \"missed_frames\": " << m_MissedFrames << ",\n  \"passes\": [";
+    for (int i = 0; i < m_PassCount; i++)
+    {
+        GpuPassStats stats = ComputeStats(m_Passes[i]);
+        out << (i ? ",\n" : "\n") << "    { \"name\": \"" << stats.name << "\", \"samples\": " << stats.samples
+            << ", \"min_ms\": " << stats.minMs << ", \"avg_ms\": " << stats.avgMs << ", \"p99_ms\": " << stats.p99Ms << " }";
+    }
+    out << "\n  ]\n}\n";
+    out.flush();
+}
+
+void GpuTimer::PrintReport(std::ostream& out) const
+{
+    out << std::fixed << std::setprecision(3);
+    for (int i = 0; i < m_PassCount; i++)
+    {
+        GpuPassStats stats = ComputeStats(m_Passes[i]);
+        out << "[GpuTime] " << std::setw(8) << stats.minMs << " min  " << std::setw(8) << stats.avgMs << " avg  "
+            << std::setw(8) << stats.p99Ms << " p99 ms  over " << std::setw(3) << stats.samples << " frames  " << stats.name << std::endl;
+    }
+    if (m_MissedFrames > 0)
+        out << "[GpuTime] " << m_MissedFrames << " frames dropped, their queries weren't ready in time" << std::endl;
+}
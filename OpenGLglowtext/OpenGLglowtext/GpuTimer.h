@@ -0,0 +1,102 @@
+#pragma once
+#include <glad/glad.h>
+#include <span>
+#include <ostream>
+#include <cstdint>
+
+// Timing of one named pass over the frames in the history window
+struct GpuPassStats
+{
+    const char* name = nullptr;
+    uint32_t samples = 0;
+    float minMs = 0.0f;
+    float avgMs = 0.0f;
+    float p99Ms = 0.0f;
+};
+
+// Named GPU timing scopes. Every Begin() / End() writes a GL_TIMESTAMP
+// query, the queries of a frame go into one slot of a ring that is
+// kFramesInFlight frames deep. BeginFrame() reads back the slot it is about
+// to reuse, by then the GPU is done with it, so nothing ever waits on a
+// query. A slot that still isn't ready is dropped and counted as missed.
+// Render thread only, needs the GL context. Doesn't allocate after the
+// constructor.
+class GpuTimer
+{
+public:
+    static constexpr int kFramesInFlight = 4;
+    static constexpr int kMaxPasses = 24;
+    static constexpr int kMaxScopesPerFrame = 48;
+    static constexpr int kMaxDepth = 8;
+    static constexpr int kHistory = 256;   // frames the stats are taken over
+
+    GpuTimer();
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    // Opens the "frame" scope around everything until EndFrame()
+    void BeginFrame();
+    void EndFrame();
+
+    // Scopes nest. name has to outlive the timer (a literal), a pass that
+    // shows up more than once in a frame gets the sum of its scopes.
+    void Begin(const char* name);
+    void End();
+
+    // Fills out in the order the passes were first seen, returns how many
+    size_t GetStats(std::span<GpuPassStats> out) const;
+    uint64_t GetMissedFrames() const { return m_MissedFrames; }
+    // The "frame" scope of the frame the last BeginFrame() read back, -1 when it got none
+    float GetCollectedFrameMs() const { return m_CollectedFrameMs; }
+
+    // One row per pass: time_s,pass,samples,min_ms,avg_ms,p99_ms
+    void WriteCsv(std::ostream& out, double time, bool header) const;
+    void WriteJson(std::ostream& out, double time) const;
+    void PrintReport(std::ostream& out) const;
+
+private:
+    struct Scope
+    {
+        int pass;
+        int beginQuery;
+        int endQuery;
+    };
+
+    struct FrameSlot
+    {
+        GLuint queries[kMaxScopesPerFrame * 2];
+        Scope scopes[kMaxScopesPerFrame];
+        int queryCount = 0;
+        int scopeCount = 0;
+        bool pending = false;
+    };
+
+    struct PassHistory
+    {
+        const char* name = nullptr;
+        float samples[kHistory];
+        int next = 0;
+        int count = 0;
+    };
+
+    int FindPass(const char* name);
+    void Collect(FrameSlot& slot);
+    GpuPassStats ComputeStats(const PassHistory& pass) const;
+
+    FrameSlot m_Slots[kFramesInFlight];
+    int m_Slot = 0;
+    bool m_InFrame = false;
+
+    int m_Open[kMaxDepth];
+    int m_Depth = 0;
+    int m_Overflow = 0;     // scopes opened past kMaxDepth
+
+    PassHistory m_Passes[kMaxPasses];
+    int m_PassCount = 0;
+
+    uint64_t m_MissedFrames = 0;
+    float m_CollectedFrameMs = -1.0f;
+    bool m_Warned = false;
+};
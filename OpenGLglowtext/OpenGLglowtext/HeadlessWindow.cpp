@@ -0,0 +1,195 @@
+#include "HeadlessWindow.h"
+#include "Platform.h"
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <chrono>
+
+#ifdef __linux__
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+// Mesa's platform without any window system, falls back to the default display
+static EGLDisplay OpenDisplay()
+{
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay)
+    {
+        EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (display != EGL_NO_DISPLAY)
+            return display;
+    }
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+HeadlessWindow::HeadlessWindow(int width, int height, const HeadlessConfig& config, GLDebugMode debugMode)
+    : m_Width(width), m_Height(height), m_Config(config), m_OpenTime(GetAppTime())
+{
+    EGLDisplay display = OpenDisplay();
+    EGLint major = 0, minor = 0;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+    {
+        std::cerr << "[Headless] No EGL display" << std::endl;
+        return;
+    }
+    m_Display = display;
+    eglBindAPI(EGL_OPENGL_API);
+
+    EGLint configAttribs[] = {
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig eglConfig;
+    EGLint configCount = 0;
+    eglChooseConfig(display, configAttribs, &eglConfig, 1, &configCount);
+
+    // Same context as the window asks for, llvmpipe stops at 4.5 which has
+    // everything the app uses
+    for (int glMinor : { 6, 5 })
+    {
+        EGLint contextAttribs[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 4,
+            EGL_CONTEXT_MINOR_VERSION, glMinor,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_CONTEXT_OPENGL_DEBUG, debugMode != GLDebugMode::Off ? EGL_TRUE : EGL_FALSE,
+            EGL_NONE
+        };
+        m_Context = eglCreateContext(display, configCount > 0 ? eglConfig : EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttribs);
+        if (m_Context != EGL_NO_CONTEXT)
+            break;
+    }
+    if (m_Context == EGL_NO_CONTEXT)
+    {
+        std::cerr << "[Headless] Failed to create a GL 4.5 core context (EGL " << major << "." << minor << ")" << std::endl;
+        m_Context = nullptr;
+        return;
+    }
+
+    // Surfaceless, the default framebuffer is replaced by m_FBO
+    MakeContextCurrent();
+    if (!LoadGL((GLADloadproc)eglGetProcAddress, debugMode))
+        return;
+
+    glCreateRenderbuffers(1, &m_ColorBuffer);
+    glNamedRenderbufferStorage(m_ColorBuffer, GL_RGBA8, width, height);
+    glCreateFramebuffers(1, &m_FBO);
+    glNamedFramebufferRenderbuffer(m_FBO, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorBuffer);
+    if (glCheckNamedFramebufferStatus(m_FBO, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "[Headless] Offscreen framebuffer is not complete" << std::endl;
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+    glViewport(0, 0, width, height);
+
+    std::cout << "[Headless] " << glGetString(GL_RENDERER) << ", " << width << "x" << height
+              << " offscreen, closing after " << config.runFor << " s" << std::endl;
+    // The script starts once the context is up, creating it takes a while on llvmpipe
+    m_OpenTime = GetAppTime();
+    m_Open = true;
+}
+
+HeadlessWindow::~HeadlessWindow()
+{
+    if (!m_Display)
+        return;
+
+    if (m_Context)
+    {
+        MakeContextCurrent();
+        if (m_Open && !m_Config.screenshotPath.empty())
+            WriteScreenshot();
+        glDeleteFramebuffers(1, &m_FBO);
+        glDeleteRenderbuffers(1, &m_ColorBuffer);
+        ReleaseContext();
+        eglDestroyContext((EGLDisplay)m_Display, (EGLContext)m_Context);
+    }
+    eglTerminate((EGLDisplay)m_Display);
+}
+
+void HeadlessWindow::SwapBuffers()
+{
+    // Nothing to present, but the frame has to be done before the next
+    // one starts, like a swap would make sure of
+    glFinish();
+}
+
+void HeadlessWindow::MakeContextCurrent()
+{
+    eglMakeCurrent((EGLDisplay)m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, (EGLContext)m_Context);
+}
+
+void HeadlessWindow::ReleaseContext()
+{
+    eglMakeCurrent((EGLDisplay)m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+}
+#else
+HeadlessWindow::HeadlessWindow(int width, int height, const HeadlessConfig& config, GLDebugMode debugMode)
+    : m_Width(width), m_Height(height), m_Config(config), m_OpenTime(GetAppTime())
+{
+    std::cerr << "[Headless] Only available on Linux" << std::endl;
+}
+
+HeadlessWindow::~HeadlessWindow()
+{
+}
+
+void HeadlessWindow::SwapBuffers()
+{
+}
+
+void HeadlessWindow::MakeContextCurrent()
+{
+}
+
+void HeadlessWindow::ReleaseContext()
+{
+}
+#endif
+
+void HeadlessWindow::PollEvents(double timeout)
+{
+    // No events, only the tick pacing of glfwWaitEventsTimeout
+    std::this_thread::sleep_for(std::chrono::duration<double>(timeout));
+}
+
+bool HeadlessWindow::ShouldClose() const
+{
+    return GetAppTime() - m_OpenTime >= m_Config.runFor;
+}
+
+bool HeadlessWindow::IsKeyDown(Key key) const
+{
+    double now = GetAppTime() - m_OpenTime;
+    for (const ScriptedKey& press : m_Config.presses)
+    {
+        if (press.key == key && now >= press.time && now < press.time + kPressSeconds)
+            return true;
+    }
+    return false;
+}
+
+void HeadlessWindow::WriteScreenshot() const
+{
+    std::vector<unsigned char> pixels((size_t)m_Width * m_Height * 3);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glNamedFramebufferReadBuffer(m_FBO, GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_FBO);
+    glReadPixels(0, 0, m_Width, m_Height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+    std::ofstream file(m_Config.screenshotPath, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "[Headless] Can't write " << m_Config.screenshotPath << std::endl;
+        return;
+    }
+    // PPM rows go top to bottom, GL's bottom to top
+    file << "P6\n" << m_Width << " " << m_Height << "\n255\n";
+    for (int y = m_Height - 1; y >= 0; y--)
+        file.write((const char*)pixels.data() + (size_t)y * m_Width * 3, (std::streamsize)m_Width * 3);
+    std::cout << "[Headless] Last frame written to " << m_Config.screenshotPath << std::endl;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "PlatformWindow.h"
+#include <string>
+#include <vector>
+
+// One key press of the input script, `time` in seconds after the window opened
+struct ScriptedKey
+{
+    Key key;
+    double time;
+};
+
+struct HeadlessConfig
+{
+    double runFor = 10.0;               // ShouldClose() after this many seconds
+    std::vector<ScriptedKey> presses;
+    std::string screenshotPath;         // the last frame as a binary PPM on exit, empty for none
+};
+
+// No window and no display: an EGL context on Mesa's surfaceless platform
+// (llvmpipe when there is no GPU) that draws into an offscreen framebuffer.
+// Keys come from a script and the window closes itself after runFor, so a
+// whole notification run works unattended on a build or benchmark host.
+// Only available on Linux, IsOpen() is false elsewhere.
+class HeadlessWindow : public PlatformWindow
+{
+public:
+    static constexpr double kPressSeconds = 0.05; // how long a scripted key stays down
+
+    HeadlessWindow(int width, int height, const HeadlessConfig& config, GLDebugMode debugMode);
+    ~HeadlessWindow() override;
+
+    bool IsOpen() const override { return m_Open; }
+
+    // Waits for the frame instead of presenting it
+    void SwapBuffers() override;
+    void PollEvents(double timeout) override;
+    bool ShouldClose() const override;
+
+    void MakeContextCurrent() override;
+    void ReleaseContext() override;
+
+    bool IsKeyDown(Key key) const override;
+
+    GLuint GetFramebuffer() const override { return m_FBO; }
+
+private:
+    // Needs the context, reads m_FBO back
+    void WriteScreenshot() const;
+
+    int m_Width;
+    int m_Height;
+    HeadlessConfig m_Config;
+    double m_OpenTime;
+    bool m_Open = false;
+
+    void* m_Display = nullptr;  // EGLDisplay / EGLContext, keeps EGL out of the header
+    void* m_Context = nullptr;
+    GLuint m_FBO = 0;
+    GLuint m_ColorBuffer = 0;
+};
@@ -0,0 +1,350 @@
+#include "JobSystem.h"
+#include "CpuProfiler.h"
+#include <algorithm>
+#include <iomanip>
+
+// Worker index of the calling thread, -1 for threads outside the pool
+static thread_local int t_WorkerIndex = -1;
+
+JobSystem::JobSystem(unsigned workerCount)
+{
+    m_Epoch = Clock::now();
+    m_ContextThread = std::this_thread::get_id();
+    m_Timeline.reserve(kTimelineJobs);
+
+    if (workerCount == 0)
+    {
+        unsigned cores = std::thread::hardware_concurrency();
+        workerCount = cores > 1 ? cores - 1 : 1; // leave one core for the calling thread
+    }
+
+    for (unsigned i = 0; i < workerCount; i++)
+        m_Queues.push_back(new WorkerQueue());
+    for (unsigned i = 0; i < workerCount; i++)
+        m_Workers.emplace_back(&JobSystem::WorkerMain, this, (int)i);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Running = false;
+    }
+    m_SleepCond.notify_all();
+
+    for (std::thread& worker : m_Workers)
+        worker.join();
+    for (WorkerQueue* queue : m_Queues)
+        delete queue;
+}
+
+double JobSystem::NowMs() const
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - m_Epoch).count();
+}
+
+JobHandle JobSystem::Submit(const char* name, std::function<void()> fn,
+                            const std::vector<JobHandle>& deps, JobAffinity affinity)
+{
+    int id;
+    uint32_t generation;
+    bool ready;
+    {
+        std::lock_guard<std::mutex> lock(m_GraphMutex);
+        if (m_FreeJobs.empty())
+        {
+            id = (int)m_Jobs.size();
+            m_Jobs.emplace_back();
+        }
+        else
+        {
+            id = m_FreeJobs.back();
+            m_FreeJobs.pop_back();
+        }
+        Job& job = m_Jobs[id];
+        job.generation++;
+        job.name = name;
+        job.fn = std::move(fn);
+        job.affinity = affinity;
+        job.pendingDeps = 0;
+        job.done = false;
+        job.thread = -1;
+        generation = job.generation;
+
+        for (JobHandle dep : deps)
+        {
+            if (!dep.IsValid())
+                continue;
+            // A reused slot means the dependency finished long ago
+            Job& parent = m_Jobs[dep.id];
+            if (parent.generation == dep.generation && !parent.done)
+            {
+                parent.dependents.push_back(id);
+                job.pendingDeps++;
+            }
+        }
+        ready = job.pendingDeps == 0;
+        m_Unfinished++;
+    }
+
+    if (ready)
+        Schedule(id);
+    return { id, generation };
+}
+
+bool JobSystem::IsDone(JobHandle handle) const
+{
+    if (!handle.IsValid())
+        return true;
+    std::lock_guard<std::mutex> lock(m_GraphMutex);
+    const Job& job = m_Jobs[handle.id];
+    return job.generation != handle.generation || job.done;
+}
+
+void JobSystem::Schedule(int jobId)
+{
+    JobAffinity affinity;
+    {
+        std::lock_guard<std::mutex> lock(m_GraphMutex);
+        affinity = m_Jobs[jobId].affinity;
+    }
+
+    if (affinity == JobAffinity::Context)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_ContextMutex);
+            m_ContextJobs.push_back(jobId);
+        }
+        m_ContextQueued++;
+        NotifyProgress();
+        return;
+    }
+
+    // Workers keep follow-up jobs local, everyone else spreads round-robin
+    int target = t_WorkerIndex >= 0 ? t_WorkerIndex : (int)(m_NextQueue++ % m_Queues.size());
+    {
+        std::lock_guard<std::mutex> lock(m_Queues[target]->mutex);
+        m_Queues[target]->jobs.push_back(jobId);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Queued++;
+    }
+    m_SleepCond.notify_one();
+}
+
+bool JobSystem::PopOrSteal(int index, int& jobId)
+{
+    int count = (int)m_Queues.size();
+
+    if (index >= 0)
+    {
+        WorkerQueue* own = m_Queues[index];
+        std::lock_guard<std::mutex> lock(own->mutex);
+        if (!own->jobs.empty())
+        {
+            jobId = own->jobs.back();
+            own->jobs.pop_back();
+            m_Queued--;
+            return true;
+        }
+    }
+
+    for (int k = 1; k <= count; k++)
+    {
+        int victim = ((index < 0 ? 0 : index) + k) % count;
+        if (victim == index)
+            continue;
+        WorkerQueue* other = m_Queues[victim];
+        std::lock_guard<std::mutex> lock(other->mutex);
+        if (!other->jobs.empty())
+        {
+            jobId = other->jobs.front();
+            other->jobs.pop_front();
+            m_Queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::Execute(int jobId, int threadIndex)
+{
+    Job* job;
+    {
+        std::lock_guard<std::mutex> lock(m_GraphMutex);
+        job = &m_Jobs[jobId];
+    }
+
+    job->thread = threadIndex;
+    job->startMs = NowMs();
+    if (job->fn)
+        job->fn();
+    job->endMs = NowMs();
+
+    std::vector<int> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_GraphMutex);
+        job->done = true;
+        job->fn = nullptr; // release captured data
+        for (int dependent : job->dependents)
+        {
+            if (--m_Jobs[dependent].pendingDeps == 0)
+                ready.push_back(dependent);
+        }
+        job->dependents.clear();
+
+        if (m_Timeline.size() < kTimelineJobs)
+            m_Timeline.push_back({ std::move(job->name), threadIndex, job->startMs, job->endMs });
+        else
+            m_UntimedJobs++;
+        m_FreeJobs.push_back(jobId);
+    }
+
+    for (int id : ready)
+        Schedule(id);
+
+    m_Unfinished--;
+    NotifyProgress();
+}
+
+void JobSystem::NotifyProgress()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+    }
+    m_DoneCond.notify_all();
+}
+
+void JobSystem::WorkerMain(int index)
+{
+    t_WorkerIndex = index;
+    CpuProfiler::SetThreadName("worker " + std::to_string(index));
+
+    while (true)
+    {
+        int jobId;
+        if (PopOrSteal(index, jobId))
+        {
+            Execute(jobId, index);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_SleepCond.wait(lock, [this] { return m_Queued > 0 || !m_Running; });
+        if (!m_Running && m_Queued == 0)
+            break;
+    }
+}
+
+void JobSystem::SetContextThread(std::thread::id id)
+{
+    m_ContextThread = id;
+}
+
+bool JobSystem::OnContextThread() const
+{
+    return std::this_thread::get_id() == m_ContextThread.load();
+}
+
+int JobSystem::RunContextJobs()
+{
+    if (!OnContextThread())
+        return 0;
+
+    int ran = 0;
+    while (true)
+    {
+        int jobId;
+        {
+            std::lock_guard<std::mutex> lock(m_ContextMutex);
+            if (m_ContextJobs.empty())
+                break;
+            jobId = m_ContextJobs.front();
+            m_ContextJobs.pop_front();
+        }
+        m_ContextQueued--;
+        Execute(jobId, -1);
+        ran++;
+    }
+    return ran;
+}
+
+void JobSystem::Wait(JobHandle handle)
+{
+    while (!IsDone(handle))
+    {
+        // Help out instead of idling: GL work first, then steal CPU work
+        if (RunContextJobs() > 0)
+            continue;
+
+        int jobId;
+        if (PopOrSteal(t_WorkerIndex, jobId))
+        {
+            Execute(jobId, t_WorkerIndex);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_DoneCond.wait_for(lock, std::chrono::milliseconds(1),
+            [this] { return (m_ContextQueued > 0 && OnContextThread()) || m_Queued > 0; });
+    }
+}
+
+void JobSystem::WaitAll()
+{
+    while (m_Unfinished > 0)
+    {
+        if (RunContextJobs() > 0)
+            continue;
+
+        int jobId;
+        if (PopOrSteal(t_WorkerIndex, jobId))
+        {
+            Execute(jobId, t_WorkerIndex);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_DoneCond.wait_for(lock, std::chrono::milliseconds(1),
+            [this] { return (m_ContextQueued > 0 && OnContextThread()) || m_Queued > 0 || m_Unfinished == 0; });
+    }
+}
+
+void JobSystem::PrintTimeline(std::ostream& out) const
+{
+    std::vector<TimelineEntry> entries;
+    uint64_t untimed;
+    {
+        std::lock_guard<std::mutex> lock(m_GraphMutex);
+        entries = m_Timeline;
+        untimed = m_UntimedJobs;
+    }
+    if (entries.empty())
+        return;
+
+    std::sort(entries.begin(), entries.end(),
+        [](const TimelineEntry& a, const TimelineEntry& b) { return a.startMs < b.startMs; });
+
+    double first = entries.front().startMs;
+    double last = 0.0;
+    double busy = 0.0;
+
+    out << std::fixed << std::setprecision(2);
+    out << "[Jobs] timeline (" << m_Workers.size() << " workers)" << std::endl;
+    for (const TimelineEntry& e : entries)
+    {
+        std::string where = e.thread < 0 ? "caller" : "worker " + std::to_string(e.thread);
+        out << "[Jobs] " << std::setw(8) << e.startMs << " ms  " << std::setw(7) << (e.endMs - e.startMs)
+            << " ms  " << std::setw(9) << where << "  " << e.name << std::endl;
+        last = std::max(last, e.endMs);
+        busy += e.endMs - e.startMs;
+    }
+    double wall = last - first;
+    out << "[Jobs] wall " << wall << " ms, busy " << busy << " ms";
+    if (wall > 0.0)
+        out << " (x" << busy / wall << " parallel)";
+    out << std::endl;
+    if (untimed > 0)
+        out << "[Jobs] " << untimed << " later jobs not shown" << std::endl;
+}
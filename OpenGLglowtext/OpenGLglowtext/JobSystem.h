@@ -0,0 +1,131 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+// The slot of a finished job is reused, generation tells the jobs of a slot apart
+struct JobHandle
+{
+    int id = -1;
+    uint32_t generation = 0;
+    bool IsValid() const { return id >= 0; }
+};
+
+enum class JobAffinity
+{
+    Worker,  // any pool thread, CPU only work
+    Context  // must run on the thread that owns the GL context
+};
+
+// Small work-stealing thread pool with a dependency graph.
+// Every worker owns a deque: it pops its own work from the back and steals
+// from the front of the others. Context jobs are never picked up by workers,
+// the GL thread drains them with RunContextJobs(). A finished job's slot
+// goes back to a free list, a session that keeps submitting only holds as
+// many jobs as run at once.
+class JobSystem
+{
+public:
+    // PrintTimeline() shows the first this many finished jobs (startup), later ones are only counted
+    static constexpr size_t kTimelineJobs = 128;
+
+    explicit JobSystem(unsigned workerCount = 0);
+    ~JobSystem();
+
+    JobHandle Submit(const char* name, std::function<void()> fn,
+                     const std::vector<JobHandle>& deps = {},
+                     JobAffinity affinity = JobAffinity::Worker);
+
+    bool IsDone(JobHandle handle) const;
+
+    // The thread that currently owns the GL context (the creator of the
+    // JobSystem by default). No thread owns it while the context moves.
+    void SetContextThread(std::thread::id id);
+
+    // Runs ready context jobs on the calling thread, returns how many ran.
+    // Does nothing on any thread but the context thread.
+    int RunContextJobs();
+
+    // Blocks until the job finished. Waiting on a job that depends on a
+    // context job from another thread than the context thread relies on the
+    // context thread to run it.
+    void Wait(JobHandle handle);
+    void WaitAll();
+
+    unsigned GetWorkerCount() const { return (unsigned)m_Workers.size(); }
+
+    void PrintTimeline(std::ostream& out) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Job
+    {
+        uint32_t generation = 0;
+        std::string name;
+        std::function<void()> fn;
+        JobAffinity affinity = JobAffinity::Worker;
+        int pendingDeps = 0;
+        std::vector<int> dependents;
+        std::atomic<bool> done = false;
+
+        int thread = -1;   // worker index, -1 = calling (context) thread
+        double startMs = 0.0;
+        double endMs = 0.0;
+    };
+
+    struct TimelineEntry
+    {
+        std::string name;
+        int thread;
+        double startMs;
+        double endMs;
+    };
+
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<int> jobs;
+    };
+
+    void WorkerMain(int index);
+    void Schedule(int jobId);
+    void Execute(int jobId, int threadIndex);
+    bool PopOrSteal(int index, int& jobId);
+    void NotifyProgress();
+    bool OnContextThread() const;
+    double NowMs() const;
+
+    std::vector<std::thread> m_Workers;
+    std::vector<WorkerQueue*> m_Queues;
+    std::atomic<unsigned> m_NextQueue = 0;
+
+    // std::deque keeps job addresses stable while it grows
+    mutable std::mutex m_GraphMutex;
+    std::deque<Job> m_Jobs;
+    std::vector<int> m_FreeJobs;            // finished slots, reused by Submit()
+    std::vector<TimelineEntry> m_Timeline;  // the first kTimelineJobs finished
+    uint64_t m_UntimedJobs = 0;             // finished after the timeline filled up
+    std::atomic<int> m_Unfinished = 0;
+
+    std::atomic<std::thread::id> m_ContextThread;
+    std::mutex m_ContextMutex;
+    std::deque<int> m_ContextJobs;
+    std::atomic<int> m_ContextQueued = 0;
+
+    std::mutex m_SleepMutex;
+    std::condition_variable m_SleepCond;
+    std::condition_variable m_DoneCond;
+    std::atomic<int> m_Queued = 0;
+    std::atomic<bool> m_Running = true;
+
+    Clock::time_point m_Epoch;
+};
@@ -0,0 +1,239 @@
+#include "LoadTest.h"
+#include "SessionLog.h"
+#include "Distribution.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+
+static const char* const kKindNames[(int)LoadKind::Count] = { "splash", "killstreak", "pulse" };
+
+static const char* const kNames[] = {
+    "Ghost", "Soap", "Roach", "Price", "Nikolai", "Makarov", "Rook", "Viper", "Sandman", "Frost",
+    "xX_Sn1per_Xx", "NoScope", "Hunter", "Wolf", "Raven", "Kilo", "Echo", "Bravo",
+};
+
+// Outside of the atlases' ASCII range, measured and drawn as nothing
+static const char* const kUnicodeNames[] = {
+    "Zo\xC3\xAB", "\xC5\x81ukasz", "S\xC3\xB8ren", "Jos\xC3\xA9",
+    "\xD0\x94\xD0\xBC\xD0\xB8\xD1\x82\xD1\x80\xD0\xB8\xD0\xB9",     // Dmitriy
+    "\xE6\x9D\x8E\xE9\x9B\xB7",                                     // Li Lei
+    "\xCE\xA9mega",
+};
+
+static void PrintDistribution(std::ostream& out, const char* name, const Distribution& d)
+{
+    out << "[Load] " << std::left << std::setw(19) << name << std::right << std::setw(9) << d.p50 << " p50 " << std::setw(9) << d.p95 << " p95 "
+        << std::setw(9) << d.p99 << " p99 " << std::setw(9) << d.max << " max  over " << d.samples << std::endl;
+}
+
+LoadTest::LoadTest(const LoadConfig& config, double startTime)
+    : m_Config(config), m_Start(startTime)
+{
+    Generate();
+
+    size_t frames = (size_t)(m_Config.runFor * 240.0) + 16; // never more than one per simulation tick
+    m_CpuFrameMs.reserve(frames);
+    m_GpuFrameMs.reserve(frames);
+    m_Depth.reserve((size_t)(m_Config.runFor / kDepthSampleSeconds) + 2);
+    for (int i = 0; i < (int)LoadKind::Count; i++)
+        m_Latency[i].reserve(m_Requested[i]);
+}
+
+std::string LoadTest::MakeText(int length, std::mt19937& rng) const
+{
+    std::string text;
+    while ((int)text.size() < length)
+    {
+        if (!text.empty())
+            text += ' ';
+        if (m_Config.unicode && rng() % 3 == 0)
+            text += kUnicodeNames[rng() % std::size(kUnicodeNames)];
+        else
+            text += kNames[rng() % std::size(kNames)];
+    }
+    text.resize(length);
+    return text;
+}
+
+void LoadTest::Generate()
+{
+    std::mt19937 rng(m_Config.seed);
+    std::exponential_distribution<double> gap(m_Config.rate / m_Config.burst);
+    std::uniform_real_distribution<double> spread(0.0, m_Config.burst > 1 ? kBurstSeconds : 0.0);
+    std::discrete_distribution<int> kind(std::begin(m_Config.mix), std::end(m_Config.mix));
+    std::uniform_int_distribution<int> length(m_Config.minLength, m_Config.maxLength);
+
+    for (double burst = gap(rng); burst < m_Config.runFor; burst += gap(rng))
+    {
+        for (int i = 0; i < m_Config.burst; i++)
+        {
+            Request request;
+            request.time = burst + spread(rng);
+            request.kind = (LoadKind)kind(rng);
+            request.text = MakeText(length(rng), rng);
+            request.description = "Killed ^3" + MakeText(length(rng), rng) + " ^7(^3+" + std::to_string(50 + rng() % 10 * 50) + "^7)";
+            m_Requested[(int)request.kind]++;
+            m_Requests.push_back(request);
+        }
+    }
+    std::stable_sort(m_Requests.begin(), m_Requests.end(), [](const Request& a, const Request& b) { return a.time < b.time; });
+}
+
+bool LoadTest::NextRequest(double now, SessionEvent& event, LoadKind& kind)
+{
+    if (m_NextRequest == m_Requests.size() || m_Requests[m_NextRequest].time > now - m_Start)
+        return false;
+
+    // Same as the keys send
+    const Request& request = m_Requests[m_NextRequest++];
+    kind = request.kind;
+    event.time = request.time;
+    switch (request.kind)
+    {
+        case LoadKind::Splash:
+            event.kind = SessionEventKind::Notify;
+            event.notify = { .text = request.text, .description = request.description, .icon = IconId::CrosshairRed,
+                             .color = { 0.75f, 0.25f, 0.25f }, .style = SplashStyle{}, .cues = { { SoundId::MpLastStand, 0.0 } } };
+            break;
+        case LoadKind::Killstreak:
+            event.kind = SessionEventKind::Notify;
+            event.notify = { .text = request.text, .description = request.description, .icon = IconId::CompassObjpointSatallite,
+                             .color = { 0.25f, 0.75f, 0.25f }, .style = KillstreakStyle{}, .cues = { { SoundId::MpKillstrkRadar, 0.0 } } };
+            break;
+        default:
+            event.kind = SessionEventKind::PulseText;
+            event.text = request.text;
+            break;
+    }
+    return true;
+}
+
+void LoadTest::OnTick(double now, size_t queueDepth)
+{
+    double time = now - m_Start;
+    if (time < m_NextDepthSample)
+        return;
+
+    m_NextDepthSample = time + kDepthSampleSeconds;
+    if (m_Depth.size() < m_Depth.capacity())
+        m_Depth.push_back({ (float)time, (uint16_t)queueDepth });
+}
+
+void LoadTest::OnEnqueued(uint32_t notifyId, LoadKind kind, double time)
+{
+    m_EnqueueTimes[notifyId % kTrackedIds] = time;
+    m_EnqueueKinds[notifyId % kTrackedIds] = kind;
+    m_Enqueued++;
+}
+
+void LoadTest::OnPresented(const FramePacket& packet, double now, double cpuMs, float gpuMs)
+{
+    if (m_CpuFrameMs.size() < m_CpuFrameMs.capacity())
+        m_CpuFrameMs.push_back((float)cpuMs);
+    if (gpuMs >= 0.0f && m_GpuFrameMs.size() < m_GpuFrameMs.capacity())
+        m_GpuFrameMs.push_back(gpuMs);
+
+    if (packet.drawSplash && packet.splash.id != 0 && packet.splash.id != m_LastShownId)
+    {
+        m_LastShownId = packet.splash.id;
+        size_t slot = packet.splash.id % kTrackedIds;
+        std::vector<float>& latency = m_Latency[(int)m_EnqueueKinds[slot]];
+        m_Shown[(int)m_EnqueueKinds[slot]]++;
+        if (latency.size() < latency.capacity())
+            latency.push_back((float)((now - m_EnqueueTimes[slot]) * 1000.0));
+    }
+
+    if (packet.drawPulseText && packet.pulseText.birthTime != m_LastPulseBirth)
+    {
+        m_LastPulseBirth = packet.pulseText.birthTime;
+        std::vector<float>& latency = m_Latency[(int)LoadKind::Pulse];
+        m_Shown[(int)LoadKind::Pulse]++;
+        if (latency.size() < latency.capacity())
+            latency.push_back((float)((now - m_PulseTime.load()) * 1000.0));
+    }
+}
+
+void LoadTest::PrintReport(std::ostream& out, size_t pending) const
+{
+    uint64_t requested = 0, shown = 0, rejected = 0;
+    for (int i = 0; i < (int)LoadKind::Count; i++)
+    {
+        requested += m_Requested[i];
+        shown += m_Shown[i];
+        rejected += m_Rejected[i];
+    }
+    size_t maxDepth = 0;
+    double depthSum = 0.0;
+    for (const DepthSample& sample : m_Depth)
+    {
+        maxDepth = std::max(maxDepth, (size_t)sample.depth);
+        depthSum += sample.depth;
+    }
+
+    out << std::fixed << std::setprecision(1)
+        << "[Load] " << m_NextRequest << " of " << requested << " requests sent over " << m_Config.runFor << " s ("
+        << m_Requested[0] << " splash, " << m_Requested[1] << " killstreak, " << m_Requested[2] << " pulse)" << std::endl
+        << "[Load] " << shown << " shown, " << m_Dropped << " dropped (queue full), " << m_CutShort << " cut short, "
+        << rejected << " rejected (another effect was running), " << pending << " still pending" << std::endl
+        << "[Load] queue depth " << maxDepth << " max, " << (m_Depth.empty() ? 0.0 : depthSum / m_Depth.size()) << " avg" << std::endl;
+
+    out << std::setprecision(2);
+    for (int i = 0; i < (int)LoadKind::Count; i++)
+    {
+        std::string name = std::string(kKindNames[i]) + " latency";
+        if (!m_Latency[i].empty())
+            PrintDistribution(out, name.c_str(), Summarize(m_Latency[i]));
+    }
+    PrintDistribution(out, "cpu frame ms", Summarize(m_CpuFrameMs));
+    if (!m_GpuFrameMs.empty())
+        PrintDistribution(out, "gpu frame ms", Summarize(m_GpuFrameMs));
+}
+
+bool LoadTest::WriteJson(const std::string& path, size_t pending, uint64_t droppedPackets) const
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "[Load] Couldn't write " << path << std::endl;
+        return false;
+    }
+
+    out << std::fixed << std::setprecision(3)
+        << "{\n  \"config\": { \"seconds\": " << m_Config.runFor << ", \"rate\": " << m_Config.rate
+        << ", \"mix\": [" << m_Config.mix[0] << ", " << m_Config.mix[1] << ", " << m_Config.mix[2] << "], \"burst\": " << m_Config.burst
+        << ", \"text_length\": [" << m_Config.minLength << ", " << m_Config.maxLength << "], \"unicode\": " << (m_Config.unicode ? "true" : "false")
+        << ", \"seed\": " << m_Config.seed << " },\n";
+
+    out << "  \"requests\": {";
+    for (int i = 0; i < (int)LoadKind::Count; i++)
+        out << (i ? ", " : " ") << "\"" << kKindNames[i] << "\": " << m_Requested[i];
+    out << " },\n  \"shown\": {";
+    for (int i = 0; i < (int)LoadKind::Count; i++)
+        out << (i ? ", " : " ") << "\"" << kKindNames[i] << "\": " << m_Shown[i];
+    out << " },\n  \"rejected\": {";
+    for (int i = 0; i < (int)LoadKind::Count; i++)
+        out << (i ? ", " : " ") << "\"" << kKindNames[i] << "\": " << m_Rejected[i];
+    out << " },\n  \"enqueued\": " << m_Enqueued << ",\n  \"dropped\": " << m_Dropped << ",\n  \"cut_short\": " << m_CutShort
+        << ",\n  \"pending\": " << pending << ",\n  \"dropped_packets\": " << droppedPackets << ",\n";
+
+    out << "  \"latency_ms\": {";
+    for (int i = 0; i < (int)LoadKind::Count; i++)
+    {
+        out << (i ? ",\n" : "\n") << "    \"" << kKindNames[i] << "\": ";
+        WriteDistribution(out, Summarize(m_Latency[i]));
+    }
+    out << "\n  },\n  \"cpu_frame_ms\": ";
+    WriteDistribution(out, Summarize(m_CpuFrameMs));
+    out << ",\n  \"gpu_frame_ms\": ";
+    WriteDistribution(out, Summarize(m_GpuFrameMs));
+
+    out << ",\n  \"queue_depth\": [";
+    for (size_t i = 0; i < m_Depth.size(); i++)
+        out << (i ? ", " : "") << "[" << std::setprecision(1) << m_Depth[i].time << ", " << m_Depth[i].depth << "]";
+    out << "]\n}\n";
+
+    std::cout << "[Load] Results written to " << path << std::endl;
+    return true;
+}
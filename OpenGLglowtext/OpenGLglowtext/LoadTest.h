@@ -0,0 +1,111 @@
+#pragma once
+#include "FramePacket.h"
+#include <atomic>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+struct SessionEvent;
+
+// What --load-test generates
+struct LoadConfig
+{
+    double runFor = 0.0;            // --load-test <seconds>, 0 when off
+    double rate = 10.0;             // --load-rate: requests per second on average
+    int mix[3] = { 6, 3, 1 };       // --load-mix <splash>:<killstreak>:<pulse>, relative weights
+    int burst = 1;                  // --load-burst: requests arriving together, bursts keep the average rate
+    int minLength = 8;              // --load-text <min>-<max>: characters per text, cut off at
+    int maxLength = 24;             // the notification's capacity (63 title, 127 description)
+    bool unicode = false;           // --load-unicode: mix UTF-8 names in (the atlases have no glyphs for them)
+    uint32_t seed = 1;              // --load-seed
+    std::string outPath;            // --load-out <file.json>
+};
+
+enum class LoadKind
+{
+    Splash,
+    Killstreak,
+    Pulse,
+    Count
+};
+
+// Synthetic load for the notification system: requests arrive in bursts
+// with exponential gaps (a Poisson process), each one a splash, killstreak
+// or typewriter pulse by the mix, with generated text. Measures how long a
+// request takes to reach the screen, how deep the queue gets, what was
+// dropped, cut short or rejected, and the frame times. Everything is
+// generated and reserved up front, the run itself doesn't allocate for it.
+class LoadTest
+{
+public:
+    LoadTest(const LoadConfig& config, double startTime);
+
+    // Simulation thread. The next request due at `now` as the event that
+    // starts it, false when none is.
+    bool NextRequest(double now, SessionEvent& event, LoadKind& kind);
+
+    // Simulation thread
+    void OnTick(double now, size_t queueDepth);
+    void OnEnqueued(uint32_t notifyId, LoadKind kind, double time);
+    void OnPulseStarted(double time) { m_PulseTime = time; }
+    void CountDropped() { m_Dropped++; }
+    void CountCutShort() { m_CutShort++; }
+    void CountRejected(LoadKind kind) { m_Rejected[(int)kind]++; }
+
+    // Render thread, after the packet's frame was presented. gpuMs < 0 when unknown.
+    void OnPresented(const FramePacket& packet, double now, double cpuMs, float gpuMs);
+
+    // Once the render thread stopped. pending: notifications still queued or on screen.
+    void PrintReport(std::ostream& out, size_t pending) const;
+    bool WriteJson(const std::string& path, size_t pending, uint64_t droppedPackets) const;
+
+private:
+    struct Request
+    {
+        double time;        // since the start
+        LoadKind kind;
+        NotifyText text;
+        NotifyDescription description;
+    };
+    struct DepthSample
+    {
+        float time;
+        uint16_t depth;
+    };
+
+    // Ids wrap around this, long after the queue moved past them
+    static constexpr size_t kTrackedIds = 1024;
+    static constexpr double kDepthSampleSeconds = 0.1;
+    static constexpr double kBurstSeconds = 0.1;    // a burst lands within this
+
+    void Generate();
+    std::string MakeText(int length, std::mt19937& rng) const;
+
+    LoadConfig m_Config;
+    double m_Start;
+
+    std::vector<Request> m_Requests;
+    size_t m_NextRequest = 0;
+    uint64_t m_Requested[(int)LoadKind::Count] = {};
+
+    // Written by the simulation before the packet that shows them, read by the render thread
+    double m_EnqueueTimes[kTrackedIds] = {};
+    LoadKind m_EnqueueKinds[kTrackedIds] = {};
+    std::atomic<double> m_PulseTime = -1.0;
+    uint32_t m_LastShownId = 0;
+    float m_LastPulseBirth = -1.0f;
+
+    uint64_t m_Enqueued = 0;
+    uint64_t m_Dropped = 0;
+    uint64_t m_CutShort = 0;
+    uint64_t m_Rejected[(int)LoadKind::Count] = {};
+    uint64_t m_Shown[(int)LoadKind::Count] = {};
+
+    double m_NextDepthSample = 0.0;
+    std::vector<DepthSample> m_Depth;
+    std::vector<float> m_Latency[(int)LoadKind::Count];  // ms, request to its first presented frame
+    std::vector<float> m_CpuFrameMs;
+    std::vector<float> m_GpuFrameMs;
+};
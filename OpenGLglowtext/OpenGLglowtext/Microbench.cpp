@@ -0,0 +1,257 @@
+#include "Microbench.h"
+#include "TextLayout.h"
+#include "FontRaster.h"
+#include "AssetArchive.h"
+#include "AssetManifest.h"
+#include "SplashAnim.h"
+#include "Platform.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+
+// Texture the benchmark glyphs claim to be on, nothing is uploaded
+static const GLuint kFakeGlyphTexture = 1;
+
+static const size_t kTextLengths[] = { 10, 100, 1000, 10000 };
+static const int kFontSizes[] = { 24, 48, 96 };
+
+static double Median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+}
+
+void Microbench::Add(Result&& result)
+{
+    std::cout << std::fixed << std::setprecision(1) << "[Bench] " << std::left << std::setw(46) << result.name << std::right
+              << std::setw(12) << *std::min_element(result.wallNs.begin(), result.wallNs.end()) << " ns min "
+              << std::setw(12) << Median(result.wallNs) << " ns median  (" << result.iterations << " iterations)" << std::endl;
+    m_Results.push_back(std::move(result));
+}
+
+bool Microbench::WriteJson(const std::string& path) const
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "[Bench] Couldn't write " << path << std::endl;
+        return false;
+    }
+
+#ifdef NDEBUG
+    const char* buildType = "release";
+#else
+    const char* buildType = "debug";
+#endif
+    out << std::fixed << std::setprecision(3)
+        << "{\n  \"context\": { \"executable\": \"OpenGLglowtext\", \"num_cpus\": " << std::thread::hardware_concurrency()
+        << ", \"library_build_type\": \"" << buildType << "\", \"repetitions\": " << kRepetitions << " },\n  \"benchmarks\": [";
+
+    // Every repetition, then its min and median aggregates
+    bool first = true;
+    auto write = [&out, &first](const Result& result, const std::string& name, const char* runType, double wallNs, double cpuNs)
+    {
+        out << (first ? "\n" : ",\n") << "    { \"name\": \"" << name << "\", \"run_name\": \"" << result.name << "\", \"run_type\": \""
+            << runType << "\", \"iterations\": " << result.iterations << ", \"real_time\": " << wallNs << ", \"cpu_time\": " << cpuNs
+            << ", \"time_unit\": \"ns\" }";
+        first = false;
+    };
+    for (const Result& result : m_Results)
+    {
+        for (size_t i = 0; i < result.wallNs.size(); i++)
+            write(result, result.name, "iteration", result.wallNs[i], result.cpuNs[i]);
+        write(result, result.name + "_min", "aggregate", *std::min_element(result.wallNs.begin(), result.wallNs.end()),
+              *std::min_element(result.cpuNs.begin(), result.cpuNs.end()));
+        write(result, result.name + "_median", "aggregate", Median(result.wallNs), Median(result.cpuNs));
+    }
+    out << "\n  ]\n}\n";
+
+    std::cout << "[Bench] " << m_Results.size() << " results written to " << path << std::endl;
+    return true;
+}
+
+// Printable ASCII in word sized runs, with a ^N color code every few words when colored
+static std::string MakeText(size_t length, bool colored, std::mt19937& rng)
+{
+    std::string text;
+    text.reserve(length);
+    size_t word = 0;
+    while (text.size() < length)
+    {
+        if (colored && word % 4 == 0 && text.size() + 2 <= length)
+        {
+            text += '^';
+            text += (char)('0' + rng() % 8);
+        }
+        size_t letters = 2 + rng() % 8;
+        for (size_t i = 0; i < letters && text.size() < length; i++)
+            text += (char)('!' + rng() % ('~' - '!' + 1));
+        if (text.size() < length)
+            text += ' ';
+        word++;
+    }
+    return text;
+}
+
+static void BenchText(Microbench& bench, const std::map<char, Character>& font)
+{
+    std::mt19937 rng(1);
+    for (size_t length : kTextLengths)
+    {
+        std::string plain = MakeText(length, false, rng);
+        std::string colored = MakeText(length, true, rng);
+        std::string suffix = std::string(1, '/') + std::to_string(length);
+
+        bench.Run("MeasureText" + suffix, [&](uint64_t iterations)
+        {
+            for (uint64_t i = 0; i < iterations; i++)
+                KeepResult(MeasureText(font, plain, 1.5f, false));
+        });
+
+        // What Application::GetTextWidth runs
+        bench.Run("GetTextWidth" + suffix, [&](uint64_t iterations)
+        {
+            for (uint64_t i = 0; i < iterations; i++)
+                KeepResult(MeasureText(font, colored, 1.5f, true).x);
+        });
+
+        // RenderColoredText without the batch: color codes and glyph placement
+        bench.Run("ColoredTextLayout" + suffix, [&](uint64_t iterations)
+        {
+            for (uint64_t i = 0; i < iterations; i++)
+            {
+                float sum = 0.0f;
+                LayoutColoredText(font, colored, 100.0f, 200.0f, 1.5f, 0.8f,
+                    [&sum](const Character& ch, float x, float y, float w, float h, const glm::vec3& color)
+                    {
+                        sum += x + y + w + h + color.x + ch.Layer;
+                    });
+                KeepResult(sum);
+            }
+        });
+    }
+}
+
+static void BenchDecay(Microbench& bench)
+{
+    for (size_t length : kTextLengths)
+    {
+        std::string suffix = std::string(1, '/') + std::to_string(length);
+        std::vector<int> indices(length);
+        std::vector<DecayEntry> order;
+        order.reserve(length);
+
+        // StartPulseText's shuffle and batches, the seed changes like the birth time does
+        bench.Run("BuildDecayOrder" + suffix, [&](uint64_t iterations)
+        {
+            for (uint64_t i = 0; i < iterations; i++)
+            {
+                BuildDecayOrder(indices, (uint32_t)i, order);
+                KeepResult(order.back().startTime);
+            }
+        });
+
+        // DrawPulseTextLayers looks up every letter once per frame
+        BuildDecayOrder(indices, 1234, order);
+        bench.Run("FindDecayEntry/frame" + suffix, [&](uint64_t iterations)
+        {
+            for (uint64_t i = 0; i < iterations; i++)
+            {
+                float sum = 0.0f;
+                for (size_t letter = 0; letter < length; letter++)
+                {
+                    if (const DecayEntry* entry = FindDecayEntry(order, (int)letter))
+                        sum += entry->startTime;
+                }
+                KeepResult(sum);
+            }
+        });
+    }
+}
+
+static void BenchSplash(Microbench& bench)
+{
+    // Steps the manual clock 1/240 s per call, through every phase and around again
+    const double step = 1.0 / 240.0;
+    auto run = [step](uint64_t iterations, auto&& call)
+    {
+        SplashAnim anim;
+        double time = 0.0;
+        SetManualAppTime(time);
+        anim.Start();
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            time += step;
+            SetManualAppTime(time);
+            KeepResult(call(anim));
+            if (anim.IsFinished())
+                anim.Start();
+        }
+    };
+
+    bench.Run("SplashAnim/GetValue", [&](uint64_t iterations)
+    {
+        run(iterations, [](SplashAnim& anim) { return anim.GetValue(0.0, 1.0); });
+    });
+    bench.Run("SplashAnim/GetSlideMW2", [&](uint64_t iterations)
+    {
+        run(iterations, [](SplashAnim& anim) { anim.Update(); return anim.GetSlideMW2(400.0) + anim.GetAlphaMW2(); });
+    });
+}
+
+static void BenchFonts(Microbench& bench, AssetArchive& assets)
+{
+    for (int id = 0; id < (int)FontId::Count; id++)
+    {
+        const AssetRef& asset = GetAsset((FontId)id);
+        for (int size : kFontSizes)
+        {
+            // LoadFontAtlas without a cooked atlas: rasterize, pack, then the glyph set
+            bench.Run(std::string("LoadFont/") + asset.File() + "/" + std::to_string(size), [&](uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; i++)
+                {
+                    AssetBlob font = assets.Load(asset);
+                    TextureData atlas = BuildGlyphAtlas(RasterizeFont(font.data, font.size, size));
+                    KeepResult(BuildCharacters(atlas, kFakeGlyphTexture).size());
+                }
+            });
+        }
+    }
+}
+
+int RunMicrobenchmarks(const BenchConfig& config)
+{
+    Microbench bench(config);
+    std::cout << "[Bench] " << Microbench::kRepetitions << " repetitions of at least " << Microbench::kMinRunSeconds * 1000.0
+              << " ms per benchmark" << std::endl;
+
+    AssetArchive assets;
+    assets.Open(GetExecutableDirectory() + "/assets.pak", GetExecutableDirectory(), kManifestStamp);
+
+    int exitCode = 0;
+    AssetBlob font = assets.Load(GetAsset(FontId::BankGothicMediumBt));
+    if (font)
+    {
+        TextureData atlas = BuildGlyphAtlas(RasterizeFont(font.data, font.size, kFontPixelSize));
+        BenchText(bench, BuildCharacters(atlas, kFakeGlyphTexture));
+    }
+    else
+    {
+        std::cerr << "[Bench] Failed to load " << GetAsset(FontId::BankGothicMediumBt).name << ", the text and font benchmarks are skipped" << std::endl;
+        exitCode = 1;
+    }
+    BenchDecay(bench);
+    BenchSplash(bench);
+    if (font)
+        BenchFonts(bench, assets);
+
+    if (bench.GetCount() == 0)
+        std::cerr << "[Bench] Nothing matches --bench-filter " << config.filter << std::endl;
+    if (!config.outPath.empty() && !bench.WriteJson(config.outPath))
+        exitCode = 1;
+    return exitCode;
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// What --bench runs
+struct BenchConfig
+{
+    bool run = false;               // --bench
+    std::string filter;             // --bench-filter <text>: only benchmarks whose name contains it
+    std::string outPath;            // --bench-out <file.json>
+};
+
+// Makes the compiler compute value even when nothing reads it. GCC and
+// Clang get an empty asm that claims to read it; MSVC has no inline asm on
+// x64, so the bytes are folded into a volatile store there.
+template <typename T>
+inline void KeepResult(const T& value)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "m"(value) : "memory");
+#else
+    static volatile unsigned char s_Sink;
+    const unsigned char* bytes = (const unsigned char*)&value;
+    unsigned char folded = 0;
+    for (size_t i = 0; i < sizeof(T); i++)
+        folded ^= bytes[i];
+    s_Sink = s_Sink ^ folded;
+#endif
+}
+
+// A small benchmark harness for CPU kernels: every benchmark is calibrated
+// to run for about kMinRunSeconds, then timed kRepetitions times. Reports
+// the min and median time per operation, and writes them in the JSON
+// layout of Google Benchmark so the usual compare tools read it.
+class Microbench
+{
+public:
+    explicit Microbench(const BenchConfig& config) : m_Config(config) {}
+
+    // body(iterations) runs the operation iterations times, setup outside of it
+    template <typename Body>
+    void Run(const std::string& name, Body&& body)
+    {
+        if (!m_Config.filter.empty() && name.find(m_Config.filter) == std::string::npos)
+            return;
+
+        body(1); // warm up caches and lazy statics
+        uint64_t iterations = 1;
+        while (true)
+        {
+            double seconds = Time(body, iterations).wall;
+            if (seconds >= kMinRunSeconds || iterations >= kMaxIterations)
+                break;
+            // Aim a bit past the target, grow at most 10x per step
+            double factor = seconds > 0.0 ? kMinRunSeconds * 1.2 / seconds : 10.0;
+            iterations = std::min<uint64_t>((uint64_t)(iterations * std::min(std::max(factor, 1.5), 10.0)) + 1, kMaxIterations);
+        }
+
+        Result result{ name, iterations, {}, {} };
+        for (int i = 0; i < kRepetitions; i++)
+        {
+            Sample sample = Time(body, iterations);
+            result.wallNs.push_back(sample.wall * 1e9 / iterations);
+            result.cpuNs.push_back(sample.cpu * 1e9 / iterations);
+        }
+        Add(std::move(result));
+    }
+
+    size_t GetCount() const { return m_Results.size(); }
+    bool WriteJson(const std::string& path) const;
+
+    static constexpr double kMinRunSeconds = 0.05;
+    static constexpr int kRepetitions = 5;
+    static constexpr uint64_t kMaxIterations = 1ull << 30;
+
+private:
+    struct Sample
+    {
+        double wall;
+        double cpu;
+    };
+    struct Result
+    {
+        std::string name;
+        uint64_t iterations;
+        std::vector<double> wallNs;     // per operation, one per repetition
+        std::vector<double> cpuNs;
+    };
+
+    template <typename Body>
+    static Sample Time(Body& body, uint64_t iterations)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::clock_t cpuStart = std::clock();
+        body(iterations);
+        std::clock_t cpuEnd = std::clock();
+        auto end = std::chrono::steady_clock::now();
+        return { std::chrono::duration<double>(end - start).count(), (double)(cpuEnd - cpuStart) / CLOCKS_PER_SEC };
+    }
+
+    void Add(Result&& result);
+
+    BenchConfig m_Config;
+    std::vector<Result> m_Results;
+};
+
+// The CPU side text and animation kernels: measuring, color codes, the
+// typewriter decay schedule, splash easing and font loading. Runs before
+// any window or GL context exists. 0 when every benchmark ran.
+int RunMicrobenchmarks(const BenchConfig& config);
@@ -0,0 +1,189 @@
+#pragma once
+#include "AssetManifest.h"
+#include "SplashAnim.h"
+#include <glm/glm.hpp>
+#include <variant>
+#include <concepts>
+
+// Animation values of one simulated frame
+struct SplashMotion
+{
+    double alpha = 0.0;
+    double scale = 1.0;
+    double x = 0.0;
+    float textScale = 1.0f;
+};
+
+// What a style's layout gets from the render side
+struct SplashFrame
+{
+    glm::vec2 center;
+    glm::vec2 mainSize;  // the title measured in the description font, at textScale
+    float iconSize;
+    float textScale;
+    float scale;
+    float alpha;
+    float x;
+};
+
+// Where the parts of the notification go this frame
+struct SplashGeometry
+{
+    float xOffset = 0.0f;
+    float textY = 0.0f;
+    float textScale = 1.0f;
+    float descY = 0.0f;
+    float descScale = 0.0f;
+    float iconDrawY = 0.0f;
+};
+
+// Notification styles are policy types: constants for the fonts, scales,
+// glow and queue behaviour, and the animation and layout as static
+// functions. The simulation and render paths are templates over the style,
+// so there is nothing to look up per frame.
+
+// Zooms in from 10x while fading in and settles below its start position
+struct SplashStyle
+{
+    static constexpr FontId kTitleFont = FontId::MsReferenceSansSerifBold;
+    static constexpr float kTextScale = 0.5f;
+    static constexpr float kDescScale = 0.375f;
+    static constexpr float kGlowRadius = 5.0f;    // times alpha
+    static constexpr bool kUrgent = false;        // cuts a yielding style short while it comes in
+    static constexpr bool kYieldsToUrgent = true;
+    static constexpr bool kChainsSameStyle = true; // the next one of this style starts as soon as this one holds
+
+    static SplashMotion Animate(SplashAnim& anim)
+    {
+        SplashMotion motion;
+        motion.scale = anim.GetValue(10.0, 1.0);
+        motion.alpha = anim.GetValue(0.0, 1.0);
+        motion.x = 0.0;
+        motion.textScale = kTextScale;
+        return motion;
+    }
+
+    static SplashGeometry Layout(const SplashFrame& frame)
+    {
+        constexpr float kStartYOffset = 260.0f;
+        constexpr float kEndYOffset = 180.0f;
+
+        float t = glm::clamp(frame.alpha, 0.0f, 1.0f);
+        float startY = frame.center.y + kStartYOffset;
+        float textCenterY = frame.center.y + kEndYOffset;
+        float iconCenterY = textCenterY + frame.mainSize.y * 3.3f;
+        float descCenterY = textCenterY - frame.mainSize.y * 2.5f;
+
+        SplashGeometry geometry;
+        geometry.textY = glm::mix(startY, textCenterY, t);
+        geometry.textScale = frame.textScale * frame.scale;
+        geometry.descY = glm::mix(startY, descCenterY, t);
+        geometry.descScale = kDescScale * frame.scale;
+        geometry.iconDrawY = glm::mix(startY, iconCenterY, t) - frame.iconSize * 0.5f;
+        return geometry;
+    }
+};
+
+// MW2 killstreak: slides in from the left edge and out to the right
+struct KillstreakStyle
+{
+    static constexpr FontId kTitleFont = FontId::BankGothicMediumBt;
+    static constexpr float kTextScale = 0.6f;
+    static constexpr float kDescScale = 0.375f;
+    static constexpr float kGlowRadius = 5.0f;
+    static constexpr bool kUrgent = true;
+    static constexpr bool kYieldsToUrgent = false;
+    static constexpr bool kChainsSameStyle = false;
+
+    static SplashMotion Animate(SplashAnim& anim)
+    {
+        SplashMotion motion;
+        anim.Update();
+        motion.alpha = anim.GetAlphaMW2();
+        motion.x = anim.GetSlideMW2(640.0);
+        motion.textScale = kTextScale;
+        return motion;
+    }
+
+    static SplashGeometry Layout(const SplashFrame& frame)
+    {
+        constexpr float kYOffset = 180.0f;
+
+        SplashGeometry geometry;
+        geometry.xOffset = frame.x;
+        geometry.textY = frame.center.y + kYOffset;
+        geometry.textScale = frame.textScale;
+        geometry.descY = (frame.center.y + kYOffset) - frame.mainSize.y * 2.7f;
+        geometry.descScale = kDescScale * frame.scale;
+        geometry.iconDrawY = (frame.center.y + kYOffset) + 20.0f;
+        return geometry;
+    }
+};
+
+template <typename T>
+concept NotifyStylePolicy = requires(SplashAnim& anim, const SplashFrame& frame)
+{
+    { T::kTitleFont } -> std::convertible_to<FontId>;
+    { T::kTextScale } -> std::convertible_to<float>;
+    { T::kDescScale } -> std::convertible_to<float>;
+    { T::kGlowRadius } -> std::convertible_to<float>;
+    { T::kUrgent } -> std::convertible_to<bool>;
+    { T::kYieldsToUrgent } -> std::convertible_to<bool>;
+    { T::kChainsSameStyle } -> std::convertible_to<bool>;
+    { T::Animate(anim) } -> std::same_as<SplashMotion>;
+    { T::Layout(frame) } -> std::same_as<SplashGeometry>;
+};
+
+// Every style the app knows. A new style is a struct like the ones above,
+// registered by adding it to this list.
+using NotifyStyle = std::variant<SplashStyle, KillstreakStyle>;
+
+template <typename... Styles>
+constexpr bool AllStylePolicies(const std::variant<Styles...>*)
+{
+    return (NotifyStylePolicy<Styles> && ...);
+}
+static_assert(AllStylePolicies((const NotifyStyle*)nullptr), "a registered style is missing a member of NotifyStylePolicy");
+
+inline FontId TitleFont(const NotifyStyle& style)
+{
+    return std::visit([](auto s) { return decltype(s)::kTitleFont; }, style);
+}
+
+inline bool IsUrgent(const NotifyStyle& style)
+{
+    return std::visit([](auto s) { return decltype(s)::kUrgent; }, style);
+}
+
+inline bool YieldsToUrgent(const NotifyStyle& style)
+{
+    return std::visit([](auto s) { return decltype(s)::kYieldsToUrgent; }, style);
+}
+
+inline bool ChainsSameStyle(const NotifyStyle& style)
+{
+    return std::visit([](auto s) { return decltype(s)::kChainsSameStyle; }, style);
+}
+
+inline bool SameStyle(const NotifyStyle& a, const NotifyStyle& b)
+{
+    return a.index() == b.index();
+}
+
+// The style registered at `index`, for data that stores styles as their
+// index (recorded sessions). False when there is no such style.
+template <size_t I = 0>
+bool StyleFromIndex(size_t index, NotifyStyle& style)
+{
+    if constexpr (I < std::variant_size_v<NotifyStyle>)
+    {
+        if (index == I)
+        {
+            style.emplace<I>();
+            return true;
+        }
+        return StyleFromIndex<I + 1>(index, style);
+    }
+    else
+        return false;
+}
@@ -0,0 +1,57 @@
+#include "Platform.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <limits.h>
+#endif
+
+static const std::chrono::steady_clock::time_point s_TimeBase = std::chrono::steady_clock::now();
+static std::atomic<bool> s_ManualTime = false;
+static std::atomic<double> s_Time = 0.0;
+
+std::string GetExecutableDirectory()
+{
+#ifdef _WIN32
+    HMODULE hModule = NULL;
+    GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)&GetExecutableDirectory, &hModule);
+
+    char path[MAX_PATH];
+    GetModuleFileNameA(hModule, path, MAX_PATH);
+
+    std::string fullPath(path);
+#else
+    char path[PATH_MAX];
+    ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (length <= 0)
+        return ".";
+    std::string fullPath(path, (size_t)length);
+#endif
+    return fullPath.substr(0, fullPath.find_last_of("\\/"));
+}
+
+void ShowErrorMessage(const std::string& title, const std::string& message)
+{
+#ifdef _WIN32
+    MessageBoxA(nullptr, message.c_str(), title.c_str(), MB_ICONERROR | MB_OK);
+#else
+    std::cerr << "[" << title << "] " << message << std::endl;
+#endif
+}
+
+double GetAppTime()
+{
+    if (s_ManualTime.load(std::memory_order_acquire))
+        return s_Time.load(std::memory_order_relaxed);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - s_TimeBase).count();
+}
+
+void SetManualAppTime(double time)
+{
+    s_Time.store(time, std::memory_order_relaxed);
+    s_ManualTime.store(true, std::memory_order_release);
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+
+// The few OS services the app uses outside of its window, Win32 on
+// Windows and POSIX everywhere else
+
+// Folder of the running executable, without a trailing slash
+std::string GetExecutableDirectory();
+
+// A message box on Windows, stderr elsewhere (there may be no display)
+void ShowErrorMessage(const std::string& title, const std::string& message);
+
+// Seconds since process start on a monotonic clock, any thread
+double GetAppTime();
+
+// From the first call on GetAppTime() returns `time` until the next call
+// instead of reading the clock. A replay steps the app through its session
+// with it.
+void SetManualAppTime(double time);
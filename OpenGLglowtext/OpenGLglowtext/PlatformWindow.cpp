@@ -0,0 +1,16 @@
+#include "PlatformWindow.h"
+#include <iostream>
+
+bool PlatformWindow::LoadGL(GLADloadproc getProcAddress, GLDebugMode debugMode)
+{
+    if (!gladLoadGLLoader(getProcAddress))
+    {
+        std::cerr << "Failed to initialize GLAD\n";
+        return false;
+    }
+
+    GLDebug::Install(debugMode);
+
+    std::cout << "OpenGL: " << glGetString(GL_VERSION) << std::endl;
+    return true;
+}
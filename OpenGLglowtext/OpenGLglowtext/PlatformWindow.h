@@ -0,0 +1,40 @@
+#pragma once
+#include "GLDebug.h"
+#include <glad/glad.h>
+
+// The keys the app reacts to
+enum class Key
+{
+    Enter,
+    A,
+    D,
+    S
+};
+
+// What the app needs from its window: a GL context that can move between
+// threads, a framebuffer to present and the keyboard. WinWindow is the
+// GLFW window on Windows, HeadlessWindow renders offscreen through EGL.
+class PlatformWindow
+{
+public:
+    virtual ~PlatformWindow() = default;
+
+    // False when the backend couldn't create its context
+    virtual bool IsOpen() const = 0;
+
+    virtual void SwapBuffers() = 0;
+    virtual void PollEvents(double timeout) = 0;
+    virtual bool ShouldClose() const = 0;
+
+    virtual void MakeContextCurrent() = 0;
+    virtual void ReleaseContext() = 0;
+
+    virtual bool IsKeyDown(Key key) const = 0;
+
+    // Where a finished frame is drawn, 0 is the window's own framebuffer
+    virtual GLuint GetFramebuffer() const { return 0; }
+
+protected:
+    // Loads the GL functions of the current context and sets up its debug output
+    static bool LoadGL(GLADloadproc getProcAddress, GLDebugMode debugMode);
+};
@@ -0,0 +1,102 @@
+#include "QuadBatch.h"
+#include <cstddef>
+
+// Enough for a long description line plus title and icon
+static const size_t kInitialQuads = 256;
+
+QuadBatch::QuadBatch(Shader* shader, GLuint iconArray)
+    : m_Shader(shader), m_IconArray(iconArray)
+{
+    m_Capacity = kInitialQuads * 6;
+    m_Vertices.reserve(m_Capacity);
+
+    glCreateVertexArrays(1, &m_VAO);
+    glCreateBuffers(1, &m_VBO);
+    glNamedBufferData(m_VBO, m_Capacity * sizeof(QuadVertex), nullptr, GL_STREAM_DRAW);
+
+    glVertexArrayVertexBuffer(m_VAO, 0, m_VBO, 0, sizeof(QuadVertex));
+
+    glEnableVertexArrayAttrib(m_VAO, 0);
+    glVertexArrayAttribFormat(m_VAO, 0, 4, GL_FLOAT, GL_FALSE, offsetof(QuadVertex, posUV));
+    glVertexArrayAttribBinding(m_VAO, 0, 0);
+
+    glEnableVertexArrayAttrib(m_VAO, 1);
+    glVertexArrayAttribFormat(m_VAO, 1, 2, GL_FLOAT, GL_FALSE, offsetof(QuadVertex, layer));
+    glVertexArrayAttribBinding(m_VAO, 1, 0);
+
+    glEnableVertexArrayAttrib(m_VAO, 2);
+    glVertexArrayAttribFormat(m_VAO, 2, 3, GL_FLOAT, GL_FALSE, offsetof(QuadVertex, color));
+    glVertexArrayAttribBinding(m_VAO, 2, 0);
+
+    m_Shader->Bind();
+    m_Shader->SetInt("u_Text", 0);
+    m_Shader->SetInt("u_Icons", 1);
+}
+
+QuadBatch::~QuadBatch()
+{
+    glDeleteVertexArrays(1, &m_VAO);
+    glDeleteBuffers(1, &m_VBO);
+}
+
+void QuadBatch::SetGlyphTexture(GLuint glyphArray)
+{
+    if (glyphArray == m_GlyphArray)
+        return;
+    Flush();
+    m_GlyphArray = glyphArray;
+}
+
+void QuadBatch::AddQuad(float x, float y, float w, float h, glm::vec2 uv0, glm::vec2 uv1, glm::vec2 layer, const glm::vec3& color)
+{
+    const QuadVertex topLeft     = { { x,     y + h, uv0.x, uv0.y }, layer, color };
+    const QuadVertex bottomLeft  = { { x,     y,     uv0.x, uv1.y }, layer, color };
+    const QuadVertex bottomRight = { { x + w, y,     uv1.x, uv1.y }, layer, color };
+    const QuadVertex topRight    = { { x + w, y + h, uv1.x, uv0.y }, layer, color };
+
+    m_Vertices.push_back(topLeft);
+    m_Vertices.push_back(bottomLeft);
+    m_Vertices.push_back(bottomRight);
+
+    m_Vertices.push_back(topLeft);
+    m_Vertices.push_back(bottomRight);
+    m_Vertices.push_back(topRight);
+}
+
+void QuadBatch::AddGlyph(float x, float y, float w, float h, glm::vec2 uv0, glm::vec2 uv1, int layer, const glm::vec3& color)
+{
+    AddQuad(x, y, w, h, uv0, uv1, { (float)layer, 0.0f }, color);
+}
+
+void QuadBatch::AddIcon(float x, float y, float w, float h, int layer, const glm::vec3& color)
+{
+    // Icons are stored bottom row first
+    AddQuad(x, y, w, h, { 0.0f, 1.0f }, { 1.0f, 0.0f }, { (float)layer, 1.0f }, color);
+}
+
+void QuadBatch::Flush()
+{
+    if (m_Vertices.empty())
+        return;
+
+    if (m_Vertices.size() > m_Capacity)
+    {
+        m_Capacity = m_Vertices.capacity();
+        glNamedBufferData(m_VBO, m_Capacity * sizeof(QuadVertex), nullptr, GL_STREAM_DRAW);
+    }
+    else
+    {
+        // Orphan, the previous draw may still be reading the old storage
+        glInvalidateBufferData(m_VBO);
+    }
+    glNamedBufferSubData(m_VBO, 0, m_Vertices.size() * sizeof(QuadVertex), m_Vertices.data());
+
+    m_Shader->Bind();
+    glBindTextureUnit(0, m_GlyphArray);
+    glBindTextureUnit(1, m_IconArray);
+    glBindVertexArray(m_VAO);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)m_Vertices.size());
+    glBindVertexArray(0);
+
+    m_Vertices.clear();
+}
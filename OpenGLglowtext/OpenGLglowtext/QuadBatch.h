@@ -0,0 +1,46 @@
+#pragma once
+#include "Shader.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+// One vertex of the text / icon stream
+struct QuadVertex
+{
+    glm::vec4 posUV;   // pos.xy, uv.zw
+    glm::vec2 layer;   // array layer, 0 = glyph / 1 = icon
+    glm::vec3 color;
+};
+
+// Collects glyph and icon quads of one pass and draws them with a single
+// glDrawArrays. Glyphs sample the active font's texture array on unit 0,
+// icons the icon array on unit 1, so only a font change or an explicit
+// Flush() (render target / blend switch) breaks the batch.
+class QuadBatch
+{
+public:
+    // Needs the GL context
+    QuadBatch(Shader* shader, GLuint iconArray);
+    ~QuadBatch();
+
+    // Flushes first if quads of another font are pending
+    void SetGlyphTexture(GLuint glyphArray);
+
+    // Corners are given bottom-left / top-right, uv0 belongs to the top-left vertex
+    void AddGlyph(float x, float y, float w, float h, glm::vec2 uv0, glm::vec2 uv1, int layer, const glm::vec3& color);
+    void AddIcon(float x, float y, float w, float h, int layer, const glm::vec3& color);
+
+    void Flush();
+
+private:
+    void AddQuad(float x, float y, float w, float h, glm::vec2 uv0, glm::vec2 uv1, glm::vec2 layer, const glm::vec3& color);
+
+    Shader* m_Shader;
+    GLuint m_IconArray;
+    GLuint m_GlyphArray = 0;
+
+    GLuint m_VAO = 0;
+    GLuint m_VBO = 0;
+    size_t m_Capacity = 0; // in vertices
+    std::vector<QuadVertex> m_Vertices;
+};
@@ -0,0 +1,269 @@
+#include "RenderBench.h"
+#include "SessionLog.h"
+#include "Platform.h"
+#include "SplashAnim.h"
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+static const char* const kSceneNames[(int)BenchScene::Count] = { "splash", "killstreak", "typewriter", "glowpulse", "concurrent" };
+
+// What the keys start, the typewriter and the glow pulse show the same text
+static const char* const kPulseText = "Eliminate enemy players.";
+
+const char* GetSceneName(BenchScene scene)
+{
+    return kSceneNames[(int)scene];
+}
+
+bool SceneFromName(std::string_view name, BenchScene& scene)
+{
+    for (int i = 0; i < (int)BenchScene::Count; i++)
+    {
+        if (name == kSceneNames[i])
+        {
+            scene = (BenchScene)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static NotifyData MakeSplash()
+{
+    return {
+        .text = "First Blood!",
+        .description = "You got the first kill. (^3+100^7)",
+        .icon = IconId::CrosshairRed,
+        .color = { 0.75f, 0.25f, 0.25f },
+        .style = SplashStyle{},
+        .cues = { { SoundId::MpLastStand, 0.0 } }
+    };
+}
+
+static NotifyData MakeKillstreak()
+{
+    return {
+        .text = "3 Kill Streak!",
+        .description = "Press 6 for UAV.",
+        .icon = IconId::CompassObjpointSatallite,
+        .color = { 0.25f, 0.75f, 0.25f },
+        .style = KillstreakStyle{},
+        .cues = { { SoundId::MpKillstrkRadar, 0.0 } }
+    };
+}
+
+RenderBench::RenderBench(const RenderBenchConfig& config, int width, int height)
+    : m_Config(config), m_Width(width), m_Height(height), m_Scenes(config.scenes)
+{
+    if (m_Scenes.empty())
+    {
+        for (int i = 0; i < (int)BenchScene::Count; i++)
+            m_Scenes.push_back((BenchScene)i);
+    }
+    uint64_t ticks = 0;
+    for (BenchScene scene : m_Scenes)
+    {
+        AddSceneEvents(scene);
+        ticks += GetMaxSceneFrames(scene);
+        m_SceneEnd.push_back(ticks);
+    }
+    m_Frames.resize(ticks);
+
+    std::cout << "[RenderBench] " << m_Scenes.size() << " scenes at " << m_Width << "x" << m_Height << ", " << m_Config.frames << " frames of "
+              << std::fixed << std::setprecision(4) << m_Config.step << " s each" << std::endl;
+}
+
+void RenderBench::AddSceneEvents(BenchScene scene)
+{
+    std::vector<SessionEvent>& events = m_Events.emplace_back();
+    SessionEvent event;
+    switch (scene)
+    {
+        case BenchScene::Splash:
+            event.kind = SessionEventKind::Notify;
+            event.notify = MakeSplash();
+            events.push_back(std::move(event));
+            break;
+        case BenchScene::Killstreak:
+            event.kind = SessionEventKind::Notify;
+            event.notify = MakeKillstreak();
+            events.push_back(std::move(event));
+            break;
+        case BenchScene::Typewriter:
+            event.kind = SessionEventKind::PulseText;
+            event.text = kPulseText;
+            events.push_back(std::move(event));
+            break;
+        case BenchScene::GlowPulse:
+            event.kind = SessionEventKind::GlowPulse;
+            event.on = true;
+            events.push_back(std::move(event));
+            break;
+        case BenchScene::Concurrent:
+            for (int i = 0; i < m_Config.concurrent; i++)
+            {
+                SessionEvent notify;
+                notify.kind = SessionEventKind::Notify;
+                notify.notify = i % 2 == 0 ? MakeSplash() : MakeKillstreak();
+                notify.notify.text = "Kill " + std::to_string(i + 1) + "!";
+                events.push_back(std::move(notify));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Long enough for every notification of the concurrent scene to come and go
+// uncut, a few ticks each for the phases that end between two frames
+int RenderBench::GetMaxSceneFrames(BenchScene scene) const
+{
+    if (scene != BenchScene::Concurrent)
+        return m_Config.frames;
+    SplashAnim anim;
+    double seconds = m_Config.concurrent * (anim.duration * 2.0 + anim.holdTime);
+    int frames = (int)std::ceil(seconds / m_Config.step) + m_Config.concurrent * 4;
+    return std::max(m_Config.frames, frames);
+}
+
+bool RenderBench::Step(bool idle)
+{
+    // Killstreaks cut the splashes before them short, the concurrent scene
+    // ends once everything it requested is gone and the later scenes move up
+    if (idle && m_Scenes[m_Scene] == BenchScene::Concurrent && m_LocalTick > 0 && m_NextEvent == m_Events[m_Scene].size())
+    {
+        uint64_t unused = m_SceneEnd[m_Scene] - m_Ticks;
+        for (size_t i = m_Scene; i < m_SceneEnd.size(); i++)
+            m_SceneEnd[i] -= unused;
+    }
+    if (m_Ticks == m_SceneEnd.back())
+        return false;
+
+    if (m_Ticks == m_SceneEnd[m_Scene])
+        m_Scene++;
+    m_LocalTick = m_Ticks - GetSceneStart(m_Scene);
+    if (m_LocalTick == 0)
+        m_NextEvent = 0;
+    SetManualAppTime(kStartTime + m_LocalTick * m_Config.step);
+    m_Ticks++;
+    return true;
+}
+
+bool RenderBench::NextEvent(SessionEvent& event)
+{
+    std::vector<SessionEvent>& events = m_Events[m_Scene];
+    if (m_NextEvent == events.size() || events[m_NextEvent].time > m_LocalTick * m_Config.step)
+        return false;
+    event = std::move(events[m_NextEvent++]);
+    return true;
+}
+
+void RenderBench::AddFrame(uint64_t frameIndex, double wallMs, float gpuMs, uint64_t lag, uint64_t checksum)
+{
+    if (frameIndex < m_Frames.size())
+    {
+        m_Frames[frameIndex].wallMs = (float)wallMs;
+        m_Frames[frameIndex].checksum = checksum;
+    }
+    if (gpuMs >= 0.0f && frameIndex >= lag && frameIndex - lag < m_Frames.size())
+        m_Frames[frameIndex - lag].gpuMs = gpuMs;
+}
+
+std::vector<RenderBench::SceneResult> RenderBench::GetResults() const
+{
+    std::vector<SceneResult> results;
+    for (size_t scene = 0; scene < m_Scenes.size(); scene++)
+    {
+        uint64_t start = GetSceneStart(scene);
+        SceneResult result{ m_Scenes[scene], m_Width, m_Height, (int)(m_SceneEnd[scene] - start), {}, {}, 0, {} };
+        std::vector<float> wall;
+        std::vector<float> gpu;
+        uint64_t checksum = 14695981039346656037ull;
+        bool checksums = false;
+        for (uint64_t i = start; i < m_SceneEnd[scene]; i++)
+        {
+            const FrameRecord& frame = m_Frames[i];
+            if (frame.wallMs >= 0.0f)
+                wall.push_back(frame.wallMs);
+            if (frame.gpuMs >= 0.0f)
+                gpu.push_back(frame.gpuMs);
+            checksums = checksums || frame.checksum != 0;
+            checksum = (checksum ^ frame.checksum) * 1099511628211ull;
+            result.frameChecksums.push_back(frame.checksum);
+        }
+        result.wallMs = Summarize(std::move(wall));
+        result.gpuMs = Summarize(std::move(gpu));
+        result.checksum = checksums ? checksum : 0;
+        if (!checksums)
+            result.frameChecksums.clear();
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+void RenderBench::PrintResults(std::ostream& out, const std::vector<SceneResult>& results)
+{
+    out << "[RenderBench] " << std::left << std::setw(22) << "scene" << std::right << std::setw(9) << "wall avg" << std::setw(9) << "p50"
+        << std::setw(9) << "p99" << std::setw(9) << "gpu avg" << std::setw(9) << "p50" << std::setw(9) << "p99" << "  ms/frame" << std::endl;
+    for (const SceneResult& result : results)
+    {
+        std::string name = std::string(GetSceneName(result.scene)) + " " + std::to_string(result.width) + "x" + std::to_string(result.height);
+        out << std::fixed << std::setprecision(3) << "[RenderBench] " << std::left << std::setw(22) << name << std::right
+            << std::setw(9) << result.wallMs.avg << std::setw(9) << result.wallMs.p50 << std::setw(9) << result.wallMs.p99;
+        if (result.gpuMs.samples > 0)
+            out << std::setw(9) << result.gpuMs.avg << std::setw(9) << result.gpuMs.p50 << std::setw(9) << result.gpuMs.p99;
+        else
+            out << std::setw(27) << "no gpu timings";
+        if (result.checksum != 0)
+            out << "  " << std::hex << std::setw(16) << std::setfill('0') << result.checksum << std::dec << std::setfill(' ');
+        out << std::endl;
+    }
+}
+
+bool RenderBench::WriteJson(const std::string& path, const RenderBenchConfig& config, const std::vector<SceneResult>& results)
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "[RenderBench] Couldn't write " << path << std::endl;
+        return false;
+    }
+
+    auto writeHash = [&out](uint64_t hash)
+    {
+        out << "\"" << std::hex << std::setw(16) << std::setfill('0') << hash << std::dec << std::setfill(' ') << "\"";
+    };
+
+    out << std::fixed << std::setprecision(4)
+        << "{\n  \"config\": { \"frames\": " << config.frames << ", \"step\": " << config.step << ", \"concurrent\": " << config.concurrent
+        << ", \"hashes\": " << (config.hashes ? "true" : "false") << " },\n  \"scenes\": [";
+    out << std::setprecision(3);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const SceneResult& result = results[i];
+        out << (i ? ",\n" : "\n") << "    { \"scene\": \"" << GetSceneName(result.scene) << "\", \"width\": " << result.width
+            << ", \"height\": " << result.height << ", \"frames\": " << result.frames << ",\n      \"wall_ms\": ";
+        WriteDistribution(out, result.wallMs);
+        out << ",\n      \"gpu_ms\": ";
+        WriteDistribution(out, result.gpuMs);
+        if (result.checksum != 0)
+        {
+            out << ",\n      \"checksum\": ";
+            writeHash(result.checksum);
+            out << ",\n      \"frame_checksums\": [";
+            for (size_t frame = 0; frame < result.frameChecksums.size(); frame++)
+            {
+                out << (frame ? ", " : "");
+                writeHash(result.frameChecksums[frame]);
+            }
+            out << "]";
+        }
+        out << " }";
+    }
+    out << "\n  ]\n}\n";
+
+    std::cout << "[RenderBench] " << results.size() << " scene results written to " << path << std::endl;
+    return true;
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include "Distribution.h"
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+struct SessionEvent;
+
+enum class BenchScene
+{
+    Splash,         // one splash notification
+    Killstreak,     // one killstreak notification
+    Typewriter,     // the pulse text
+    GlowPulse,      // the glow pulse
+    Concurrent,     // splashes and killstreaks requested together, one shows while the rest queue
+    Count
+};
+
+const char* GetSceneName(BenchScene scene);
+bool SceneFromName(std::string_view name, BenchScene& scene);
+
+struct BenchResolution
+{
+    int width;
+    int height;
+};
+
+// What --render-bench runs
+struct RenderBenchConfig
+{
+    bool run = false;                           // --render-bench
+    std::vector<BenchScene> scenes;             // --render-bench-scenes <name,...>: every scene when empty
+    std::vector<BenchResolution> resolutions;   // --render-bench-res <720p|1080p|4k|WxH,...>: 720p when empty
+    int frames = 120;                           // --render-bench-frames: per scene, the concurrent one runs until its queue drained
+    double step = 1.0 / 60.0;                   // --render-bench-step: simulated seconds per frame
+    int concurrent = 8;                         // --render-bench-concurrent: notifications of the concurrent scene
+    bool hashes = false;                        // --render-bench-hashes: checksum the pixels of every frame
+    std::string outPath;                        // --render-bench-out <file.json>
+
+    // Application's notification queue holds this many besides the one on screen
+    static constexpr int kMaxConcurrent = 17;
+};
+
+// End to end render benchmark on the headless backend. Plays canned scenes
+// one after the other, each from a clean screen for the same number of
+// frames (the concurrent scene until its last notification is gone), on
+// the fixed timestep of a replay. The manual clock goes back to
+// kStartTime for every scene, and every run of the same scenes draws the
+// same frames. Times every frame on the CPU, from the start of RenderFrame
+// to its present, and on the GPU, and can hash the pixels to catch visual
+// changes along the way.
+class RenderBench
+{
+public:
+    struct SceneResult
+    {
+        BenchScene scene;
+        int width;
+        int height;
+        int frames;
+        Distribution wallMs;
+        Distribution gpuMs;
+        uint64_t checksum;                  // over every frame of the scene, 0 without hashes
+        std::vector<uint64_t> frameChecksums;
+    };
+
+    static constexpr double kStartTime = 1.0;
+
+    RenderBench(const RenderBenchConfig& config, int width, int height);
+
+    // Simulation thread. Moves the clock to the next frame, false once every
+    // scene ran. idle: nothing on screen and nothing queued after the last tick.
+    bool Step(bool idle);
+    // True on the first tick of every scene after the first, whatever the last one left running has to go
+    bool IsSceneStart() const { return m_Scene > 0 && m_LocalTick == 0; }
+    // The next event of the scene that is due at the current tick, false when none is
+    bool NextEvent(SessionEvent& event);
+
+    // Render thread, once per presented frame. gpuMs is the GPU time of
+    // frame frameIndex - lag (GpuTimer reads its queries back that late),
+    // < 0 when there is none.
+    void AddFrame(uint64_t frameIndex, double wallMs, float gpuMs, uint64_t lag, uint64_t checksum);
+
+    // Once the render thread stopped
+    std::vector<SceneResult> GetResults() const;
+
+    static void PrintResults(std::ostream& out, const std::vector<SceneResult>& results);
+    static bool WriteJson(const std::string& path, const RenderBenchConfig& config, const std::vector<SceneResult>& results);
+
+private:
+    struct FrameRecord
+    {
+        float wallMs = -1.0f;
+        float gpuMs = -1.0f;
+        uint64_t checksum = 0;
+    };
+
+    void AddSceneEvents(BenchScene scene);
+    int GetMaxSceneFrames(BenchScene scene) const;
+    uint64_t GetSceneStart(size_t scene) const { return scene == 0 ? 0 : m_SceneEnd[scene - 1]; }
+
+    RenderBenchConfig m_Config;
+    int m_Width;
+    int m_Height;
+    std::vector<BenchScene> m_Scenes;
+    std::vector<std::vector<SessionEvent>> m_Events;    // per scene, times from the scene's start
+    std::vector<uint64_t> m_SceneEnd;                   // per scene, the tick after its last (moves up when one ends early)
+    size_t m_NextEvent = 0;
+
+    uint64_t m_Ticks = 0;           // Step() calls that moved the clock
+    uint64_t m_LocalTick = 0;       // of the current scene
+    size_t m_Scene = 0;
+    std::vector<FrameRecord> m_Frames;  // one per tick of every scene at its longest, sized up front
+};
@@ -0,0 +1,289 @@
+#include "RenderStats.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+static FrameStats s_Counts;
+static FrameStats s_LastFrame;
+static bool s_Installed = false;
+
+// The loader's entry points, the counting versions forward to them
+static PFNGLDRAWARRAYSPROC s_DrawArrays;
+static PFNGLDRAWELEMENTSPROC s_DrawElements;
+static PFNGLBUFFERDATAPROC s_BufferData;
+static PFNGLBUFFERSUBDATAPROC s_BufferSubData;
+static PFNGLNAMEDBUFFERDATAPROC s_NamedBufferData;
+static PFNGLNAMEDBUFFERSUBDATAPROC s_NamedBufferSubData;
+static PFNGLNAMEDBUFFERSTORAGEPROC s_NamedBufferStorage;
+static PFNGLBINDTEXTUREPROC s_BindTexture;
+static PFNGLBINDTEXTUREUNITPROC s_BindTextureUnit;
+static PFNGLUSEPROGRAMPROC s_UseProgram;
+static PFNGLUNIFORM1IPROC s_Uniform1i;
+static PFNGLUNIFORM1FPROC s_Uniform1f;
+static PFNGLUNIFORM2FPROC s_Uniform2f;
+static PFNGLUNIFORM3FPROC s_Uniform3f;
+static PFNGLUNIFORM4FPROC s_Uniform4f;
+static PFNGLUNIFORMMATRIX4FVPROC s_UniformMatrix4fv;
+static PFNGLBINDFRAMEBUFFERPROC s_BindFramebuffer;
+static PFNGLCLEARPROC s_Clear;
+static PFNGLBLENDFUNCPROC s_BlendFunc;
+static PFNGLENABLEPROC s_Enable;
+static PFNGLDISABLEPROC s_Disable;
+
+static void CountUpload(GLsizeiptr size, const void* data)
+{
+    // Without data it only (re)allocates the storage
+    if (!data)
+        return;
+    s_Counts.bufferUploads++;
+    s_Counts.uploadBytes += (uint64_t)size;
+}
+
+static void APIENTRY CountedDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    s_Counts.drawCalls++;
+    s_DrawArrays(mode, first, count);
+}
+
+static void APIENTRY CountedDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+    s_Counts.drawCalls++;
+    s_DrawElements(mode, count, type, indices);
+}
+
+static void APIENTRY CountedBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+    CountUpload(size, data);
+    s_BufferData(target, size, data, usage);
+}
+
+static void APIENTRY CountedBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    CountUpload(size, data);
+    s_BufferSubData(target, offset, size, data);
+}
+
+static void APIENTRY CountedNamedBufferData(GLuint buffer, GLsizeiptr size, const void* data, GLenum usage)
+{
+    CountUpload(size, data);
+    s_NamedBufferData(buffer, size, data, usage);
+}
+
+static void APIENTRY CountedNamedBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    CountUpload(size, data);
+    s_NamedBufferSubData(buffer, offset, size, data);
+}
+
+static void APIENTRY CountedNamedBufferStorage(GLuint buffer, GLsizeiptr size, const void* data, GLbitfield flags)
+{
+    CountUpload(size, data);
+    s_NamedBufferStorage(buffer, size, data, flags);
+}
+
+static void APIENTRY CountedBindTexture(GLenum target, GLuint texture)
+{
+    s_Counts.textureBinds++;
+    s_BindTexture(target, texture);
+}
+
+static void APIENTRY CountedBindTextureUnit(GLuint unit, GLuint texture)
+{
+    s_Counts.textureBinds++;
+    s_BindTextureUnit(unit, texture);
+}
+
+static void APIENTRY CountedUseProgram(GLuint program)
+{
+    s_Counts.programBinds++;
+    s_UseProgram(program);
+}
+
+static void APIENTRY CountedUniform1i(GLint location, GLint v0)
+{
+    s_Counts.uniformSets++;
+    s_Uniform1i(location, v0);
+}
+
+static void APIENTRY CountedUniform1f(GLint location, GLfloat v0)
+{
+    s_Counts.uniformSets++;
+    s_Uniform1f(location, v0);
+}
+
+static void APIENTRY CountedUniform2f(GLint location, GLfloat v0, GLfloat v1)
+{
+    s_Counts.uniformSets++;
+    s_Uniform2f(location, v0, v1);
+}
+
+static void APIENTRY CountedUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+{
+    s_Counts.uniformSets++;
+    s_Uniform3f(location, v0, v1, v2);
+}
+
+static void APIENTRY CountedUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+{
+    s_Counts.uniformSets++;
+    s_Uniform4f(location, v0, v1, v2, v3);
+}
+
+static void APIENTRY CountedUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    s_Counts.uniformSets++;
+    s_UniformMatrix4fv(location, count, transpose, value);
+}
+
+static void APIENTRY CountedBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    s_Counts.framebufferBinds++;
+    s_BindFramebuffer(target, framebuffer);
+}
+
+static void APIENTRY CountedClear(GLbitfield mask)
+{
+    s_Counts.clears++;
+    s_Clear(mask);
+}
+
+static void APIENTRY CountedBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+    s_Counts.blendChanges++;
+    s_BlendFunc(sfactor, dfactor);
+}
+
+static void APIENTRY CountedEnable(GLenum cap)
+{
+    if (cap == GL_BLEND)
+        s_Counts.blendChanges++;
+    s_Enable(cap);
+}
+
+static void APIENTRY CountedDisable(GLenum cap)
+{
+    if (cap == GL_BLEND)
+        s_Counts.blendChanges++;
+    s_Disable(cap);
+}
+
+// Keeps the loaded entry point and puts the counting one in its place
+template <typename Fn>
+static void Hook(Fn& entry, Fn& original, Fn counted)
+{
+    if (!entry)
+        return;
+    original = entry;
+    entry = counted;
+}
+
+void RenderStats::Install()
+{
+    if (s_Installed)
+        return;
+
+    Hook(glad_glDrawArrays, s_DrawArrays, CountedDrawArrays);
+    Hook(glad_glDrawElements, s_DrawElements, CountedDrawElements);
+    Hook(glad_glBufferData, s_BufferData, CountedBufferData);
+    Hook(glad_glBufferSubData, s_BufferSubData, CountedBufferSubData);
+    Hook(glad_glNamedBufferData, s_NamedBufferData, CountedNamedBufferData);
+    Hook(glad_glNamedBufferSubData, s_NamedBufferSubData, CountedNamedBufferSubData);
+    Hook(glad_glNamedBufferStorage, s_NamedBufferStorage, CountedNamedBufferStorage);
+    Hook(glad_glBindTexture, s_BindTexture, CountedBindTexture);
+    Hook(glad_glBindTextureUnit, s_BindTextureUnit, CountedBindTextureUnit);
+    Hook(glad_glUseProgram, s_UseProgram, CountedUseProgram);
+    Hook(glad_glUniform1i, s_Uniform1i, CountedUniform1i);
+    Hook(glad_glUniform1f, s_Uniform1f, CountedUniform1f);
+    Hook(glad_glUniform2f, s_Uniform2f, CountedUniform2f);
+    Hook(glad_glUniform3f, s_Uniform3f, CountedUniform3f);
+    Hook(glad_glUniform4f, s_Uniform4f, CountedUniform4f);
+    Hook(glad_glUniformMatrix4fv, s_UniformMatrix4fv, CountedUniformMatrix4fv);
+    Hook(glad_glBindFramebuffer, s_BindFramebuffer, CountedBindFramebuffer);
+    Hook(glad_glClear, s_Clear, CountedClear);
+    Hook(glad_glBlendFunc, s_BlendFunc, CountedBlendFunc);
+    Hook(glad_glEnable, s_Enable, CountedEnable);
+    Hook(glad_glDisable, s_Disable, CountedDisable);
+    s_Installed = true;
+}
+
+bool RenderStats::IsInstalled()
+{
+    return s_Installed;
+}
+
+void RenderStats::BeginFrame()
+{
+    s_Counts = {};
+}
+
+FrameStats RenderStats::EndFrame()
+{
+    s_LastFrame = s_Counts;
+    s_Counts = {};
+    return s_LastFrame;
+}
+
+const FrameStats& RenderStats::GetLastFrame()
+{
+    return s_LastFrame;
+}
+
+// Every counter with its name, for the checks and the report
+struct StatField
+{
+    const char* name;
+    uint64_t FrameStats::* member;
+};
+
+static const StatField kStatFields[] = {
+    { "draw calls",        &FrameStats::drawCalls },
+    { "buffer uploads",    &FrameStats::bufferUploads },
+    { "upload bytes",      &FrameStats::uploadBytes },
+    { "texture binds",     &FrameStats::textureBinds },
+    { "program binds",     &FrameStats::programBinds },
+    { "uniform sets",      &FrameStats::uniformSets },
+    { "framebuffer binds", &FrameStats::framebufferBinds },
+    { "clears",            &FrameStats::clears },
+    { "blend changes",     &FrameStats::blendChanges },
+};
+
+BudgetCheck::BudgetCheck(const FrameBudget& budget)
+    : m_Budget(budget)
+{
+}
+
+bool BudgetCheck::Add(const FrameStats& stats, uint64_t frameIndex)
+{
+    m_Frames++;
+    bool within = true;
+    for (size_t i = 0; i < std::size(kStatFields); i++)
+    {
+        uint64_t FrameStats::* member = kStatFields[i].member;
+        m_Peak.*member = std::max(m_Peak.*member, stats.*member);
+        if (stats.*member <= m_Budget.max.*member)
+            continue;
+
+        within = false;
+        if (!(m_Reported & (1u << i)))
+        {
+            std::cerr << "[Budget] " << m_Budget.scenario << " frame " << frameIndex << ": " << stats.*member << " "
+                << kStatFields[i].name << ", the budget is " << m_Budget.max.*member << std::endl;
+            m_Reported |= 1u << i;
+        }
+    }
+    if (!within)
+        m_OverFrames++;
+    return within;
+}
+
+void BudgetCheck::PrintReport(std::ostream& out) const
+{
+    if (m_Frames == 0)
+        return;
+
+    out << "[Budget] " << m_Budget.scenario << ": " << m_OverFrames << " of " << m_Frames << " frames over budget, peak";
+    for (const StatField& field : kStatFields)
+        out << "  " << field.name << " " << m_Peak.*field.member << "/" << m_Budget.max.*field.member;
+    out << std::endl;
+}
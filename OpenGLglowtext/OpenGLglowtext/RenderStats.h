@@ -0,0 +1,63 @@
+#pragma once
+#include <ostream>
+#include <cstdint>
+
+// What the renderer asked of GL during one frame
+struct FrameStats
+{
+    uint64_t drawCalls = 0;
+    uint64_t bufferUploads = 0;     // buffer data / sub data / storage calls with data
+    uint64_t uploadBytes = 0;
+    uint64_t textureBinds = 0;
+    uint64_t programBinds = 0;
+    uint64_t uniformSets = 0;
+    uint64_t framebufferBinds = 0;
+    uint64_t clears = 0;
+    uint64_t blendChanges = 0;      // blend func calls, GL_BLEND enables / disables
+};
+
+// Counts GL calls by swapping the loader's entry points of the calls above
+// for counting ones, every caller is covered without touching it. Counting
+// is off until Install(). The counters belong to whichever thread has the
+// context, there is one at a time.
+class RenderStats
+{
+public:
+    // After the GL functions are loaded, with the context current
+    static void Install();
+    static bool IsInstalled();
+
+    // Starts a new frame's counts, whatever came before (loading) is dropped
+    static void BeginFrame();
+    // The counts since BeginFrame(), also kept for GetLastFrame()
+    static FrameStats EndFrame();
+    static const FrameStats& GetLastFrame();
+};
+
+// Upper limits for one kind of frame
+struct FrameBudget
+{
+    const char* scenario;
+    FrameStats max;
+};
+
+// Holds the frames of one scenario against its budget and keeps the peak
+// of every counter. A counter going over is printed the first time.
+class BudgetCheck
+{
+public:
+    explicit BudgetCheck(const FrameBudget& budget);
+
+    // False when a counter is above the budget
+    bool Add(const FrameStats& stats, uint64_t frameIndex);
+
+    bool Passed() const { return m_OverFrames == 0; }
+    void PrintReport(std::ostream& out) const;
+
+private:
+    FrameBudget m_Budget;
+    FrameStats m_Peak;
+    uint64_t m_Frames = 0;
+    uint64_t m_OverFrames = 0;
+    uint32_t m_Reported = 0;   // bit per counter
+};
@@ -0,0 +1,92 @@
+#include "RenderThread.h"
+#include "PlatformWindow.h"
+#include "CpuProfiler.h"
+#include <utility>
+
+RenderThread::RenderThread(PlatformWindow* window, RenderFn render, RenderFn presented)
+    : m_Window(window), m_Render(std::move(render)), m_Presented(std::move(presented))
+{
+}
+
+RenderThread::~RenderThread()
+{
+    Stop();
+}
+
+void RenderThread::Start()
+{
+    if (m_Running)
+        return;
+
+    // The context can only be current on one thread at a time
+    m_Window->ReleaseContext();
+    m_Running = true;
+    m_Thread = std::thread(&RenderThread::ThreadMain, this);
+}
+
+void RenderThread::Stop()
+{
+    if (!m_Running)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Running = false;
+    }
+    m_Cond.notify_one();
+    m_Thread.join();
+
+    // Hand the context back to the caller for teardown
+    m_Window->MakeContextCurrent();
+}
+
+void RenderThread::SubmitPacket()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_HasNewPacket)
+            m_DroppedPackets++; // previous packet was never picked up
+        std::swap(m_WriteIndex, m_ReadyIndex);
+        m_HasNewPacket = true;
+        m_SubmittedPackets++;
+    }
+    m_Cond.notify_one();
+}
+
+void RenderThread::WaitForPresent()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_PresentCond.wait(lock, [this] { return m_PresentedPackets + m_DroppedPackets == m_SubmittedPackets || !m_Running; });
+}
+
+void RenderThread::ThreadMain()
+{
+    CpuProfiler::SetThreadName("render");
+    m_Window->MakeContextCurrent();
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Cond.wait(lock, [this] { return m_HasNewPacket || !m_Running; });
+            if (!m_Running)
+                break;
+            std::swap(m_ReadIndex, m_ReadyIndex);
+            m_HasNewPacket = false;
+        }
+
+        m_Render(m_Packets[m_ReadIndex]);
+        m_Window->SwapBuffers();
+        m_RenderedFrames++;
+        if (m_Presented)
+            m_Presented(m_Packets[m_ReadIndex]);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_PresentedPackets++;
+        }
+        m_PresentCond.notify_all();
+    }
+
+    m_Window->ReleaseContext();
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "FramePacket.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+class PlatformWindow;
+
+// Owns the GL context on a dedicated thread and consumes FramePackets
+// through a triple buffer: the simulation always has a free slot to write
+// into, so it never waits for the GPU / vsync.
+class RenderThread
+{
+public:
+    using RenderFn = std::function<void(const FramePacket&)>;
+
+    // presented (optional) runs on the render thread after the packet's
+    // frame was swapped to the screen
+    RenderThread(PlatformWindow* window, RenderFn render, RenderFn presented = nullptr);
+    ~RenderThread();
+
+    void Start();
+    void Stop();
+
+    // Simulation side: fill the returned packet, then publish it.
+    FramePacket& BeginPacket() { return m_Packets[m_WriteIndex]; }
+    void SubmitPacket();
+    // Simulation side: blocks until every submitted packet was presented,
+    // runs in lockstep with it (replays) don't drop a single one
+    void WaitForPresent();
+
+    uint64_t GetRenderedFrames() const { return m_RenderedFrames; }
+    uint64_t GetDroppedPackets() const { return m_DroppedPackets; }
+
+private:
+    void ThreadMain();
+
+    PlatformWindow* m_Window;
+    RenderFn m_Render;
+    RenderFn m_Presented;
+
+    std::thread m_Thread;
+    std::atomic<bool> m_Running = false;
+
+    FramePacket m_Packets[3];
+    int m_WriteIndex = 0;
+    int m_ReadyIndex = 1;
+    int m_ReadIndex  = 2;
+    bool m_HasNewPacket = false;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Cond;
+    std::condition_variable m_PresentCond;
+    uint64_t m_SubmittedPackets = 0;    // m_Mutex
+    uint64_t m_PresentedPackets = 0;    // m_Mutex
+
+    std::atomic<uint64_t> m_RenderedFrames = 0;
+    std::atomic<uint64_t> m_DroppedPackets = 0;
+};
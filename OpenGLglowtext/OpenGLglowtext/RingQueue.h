@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <utility>
+
+// FIFO with a fixed number of slots allocated as part of the owner.
+// Items only move in and out, nothing is copied and nothing is allocated
+// once the queue exists. Not thread safe.
+template <typename T, size_t Capacity>
+class RingQueue
+{
+public:
+    // False (and the item is left alone) when every slot is taken
+    bool Push(T&& item)
+    {
+        if (m_Size == Capacity)
+            return false;
+        m_Items[(m_Head + m_Size) % Capacity] = std::move(item);
+        m_Size++;
+        return true;
+    }
+
+    // Must not be empty
+    T Pop()
+    {
+        T item = std::move(m_Items[m_Head]);
+        m_Head = (m_Head + 1) % Capacity;
+        m_Size--;
+        return item;
+    }
+
+    const T& Front() const { return m_Items[m_Head]; }
+
+    bool IsEmpty() const { return m_Size == 0; }
+    bool IsFull() const { return m_Size == Capacity; }
+    size_t GetSize() const { return m_Size; }
+
+private:
+    T m_Items[Capacity];
+    size_t m_Head = 0;
+    size_t m_Size = 0;
+};
@@ -0,0 +1,291 @@
+#include "SessionLog.h"
+#include "Platform.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+static const char kSessionMagic[4] = { 'N', 'S', 'E', 'S' };
+
+bool SessionRecorder::Open(const std::string& path, double startTime)
+{
+    m_File.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_File)
+    {
+        std::cerr << "[Session] Couldn't write " << path << ", the session isn't recorded" << std::endl;
+        return false;
+    }
+    m_Path = path;
+    m_Start = startTime;
+    m_File.write(kSessionMagic, sizeof(kSessionMagic));
+    Write(kVersion);
+    Write(startTime);
+    return true;
+}
+
+void SessionRecorder::BeginEvent(SessionEventKind kind, double time)
+{
+    Write(kind);
+    Write(time - m_Start);
+    if (kind != SessionEventKind::End)
+        m_Events++;
+}
+
+void SessionRecorder::WriteText(std::string_view text)
+{
+    // Notification text is at most 127 chars
+    uint8_t length = (uint8_t)std::min<size_t>(text.size(), 255);
+    Write(length);
+    m_File.write(text.data(), length);
+}
+
+void SessionRecorder::RecordNotify(double time, const NotifyData& data)
+{
+    BeginEvent(SessionEventKind::Notify, time);
+    WriteText(data.text);
+    WriteText(data.description);
+    Write((int16_t)data.icon);
+    Write(data.color);
+    Write((uint8_t)data.style.index());
+    Write((uint8_t)data.cues.size());
+    for (const AudioCue& cue : data.cues)
+    {
+        Write((uint16_t)cue.sound);
+        Write(cue.offset);
+    }
+    WriteText(data.announcer);
+}
+
+void SessionRecorder::RecordGlowPulse(double time, bool on)
+{
+    BeginEvent(SessionEventKind::GlowPulse, time);
+    Write((uint8_t)on);
+}
+
+void SessionRecorder::RecordPulseText(double time, std::string_view text)
+{
+    BeginEvent(SessionEventKind::PulseText, time);
+    WriteText(text);
+}
+
+void SessionRecorder::Close(double time)
+{
+    if (!m_File.is_open())
+        return;
+
+    BeginEvent(SessionEventKind::End, time);
+    m_File.close();
+    if (!m_File)
+    {
+        std::cerr << "[Session] Writing " << m_Path << " failed" << std::endl;
+        return;
+    }
+    std::cout << "[Session] " << m_Events << " events over " << std::fixed << std::setprecision(2) << time - m_Start
+              << " s recorded to " << m_Path << std::endl;
+}
+
+// Reads the fields in the order SessionRecorder wrote them
+class SessionReader
+{
+public:
+    explicit SessionReader(std::ifstream& file) : m_File(file) {}
+
+    template <typename T>
+    T Read()
+    {
+        T value{};
+        m_File.read((char*)&value, sizeof(T));
+        return value;
+    }
+
+    std::string_view ReadText()
+    {
+        uint8_t length = Read<uint8_t>();
+        m_File.read(m_Text, length);
+        return { m_Text, m_File ? length : (size_t)0 };
+    }
+
+    bool Ok() const { return (bool)m_File; }
+
+private:
+    std::ifstream& m_File;
+    char m_Text[256];
+};
+
+bool SessionReplay::Open(const std::string& path, double step)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "[Session] Couldn't open " << path << std::endl;
+        return false;
+    }
+
+    SessionReader reader(file);
+    char magic[4] = {};
+    file.read(magic, sizeof(magic));
+    uint32_t version = reader.Read<uint32_t>();
+    if (!reader.Ok() || memcmp(magic, kSessionMagic, sizeof(magic)) != 0 || version != SessionRecorder::kVersion)
+    {
+        std::cerr << "[Session] " << path << " isn't a session file of version " << SessionRecorder::kVersion << std::endl;
+        return false;
+    }
+    m_Start = reader.Read<double>();
+
+    while (true)
+    {
+        SessionEvent event;
+        event.kind = reader.Read<SessionEventKind>();
+        event.time = reader.Read<double>();
+        if (!reader.Ok())
+        {
+            std::cerr << "[Session] " << path << " ends without its end marker, was the recording cut short?" << std::endl;
+            return false;
+        }
+
+        bool valid = true;
+        switch (event.kind)
+        {
+            case SessionEventKind::Notify:
+            {
+                NotifyData& data = event.notify;
+                data.text = reader.ReadText();
+                data.description = reader.ReadText();
+                data.icon = (IconId)reader.Read<int16_t>();
+                data.color = reader.Read<glm::vec3>();
+                valid = StyleFromIndex(reader.Read<uint8_t>(), data.style) && data.icon >= IconId::None && data.icon < IconId::Count;
+                uint8_t cueCount = reader.Read<uint8_t>();
+                for (uint8_t i = 0; i < cueCount; i++)
+                {
+                    AudioCue cue;
+                    cue.sound = (SoundId)reader.Read<uint16_t>();
+                    cue.offset = reader.Read<double>();
+                    valid = valid && cue.sound < SoundId::Count && data.cues.push_back(cue);
+                }
+                data.announcer = reader.ReadText();
+                break;
+            }
+            case SessionEventKind::GlowPulse:
+                event.on = reader.Read<uint8_t>() != 0;
+                break;
+            case SessionEventKind::PulseText:
+                event.text = reader.ReadText();
+                break;
+            case SessionEventKind::End:
+                m_Duration = event.time;
+                break;
+            default:
+                valid = false;
+                break;
+        }
+        if (!reader.Ok() || !valid)
+        {
+            std::cerr << "[Session] " << path << " is damaged at event " << m_Events.size() << std::endl;
+            return false;
+        }
+        if (event.kind == SessionEventKind::End)
+            break;
+        m_Events.push_back(std::move(event));
+    }
+
+    m_Step = step;
+    m_Frames.reserve((size_t)(m_Duration / m_Step) + 2);
+    std::cout << "[Session] Replaying " << m_Events.size() << " events over " << std::fixed << std::setprecision(2) << m_Duration
+              << " s from " << path << ", " << std::setprecision(4) << m_Step << " s steps" << std::endl;
+    return true;
+}
+
+bool SessionReplay::Step()
+{
+    double time = m_Tick * m_Step;
+    if (time > m_Duration)
+        return false;
+
+    if (m_Tick == 0)
+        m_WallStartMs = StartupReport::Now();
+    m_SessionTime = time;
+    SetManualAppTime(m_Start + time);
+    m_Tick++;
+    return true;
+}
+
+bool SessionReplay::NextEvent(SessionEvent& event)
+{
+    if (m_NextEvent == m_Events.size() || m_Events[m_NextEvent].time > m_SessionTime)
+        return false;
+    event = std::move(m_Events[m_NextEvent++]);
+    return true;
+}
+
+void SessionReplay::AddFrame(uint64_t frameIndex, double appTime, double frameMs, uint64_t checksum)
+{
+    m_WallEndMs = StartupReport::Now();
+    if (m_Frames.size() < m_Frames.capacity())
+        m_Frames.push_back({ frameIndex, appTime - m_Start, frameMs, checksum });
+}
+
+uint64_t SessionReplay::Checksum(const unsigned char* data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void SessionReplay::PrintReport(std::ostream& out) const
+{
+    if (m_Frames.empty())
+        return;
+
+    std::vector<double> sorted;
+    sorted.reserve(m_Frames.size());
+    uint64_t sessionChecksum = 14695981039346656037ull;
+    bool checksums = false;
+    for (const FrameRecord& frame : m_Frames)
+    {
+        sorted.push_back(frame.frameMs);
+        checksums = checksums || frame.checksum != 0;
+        sessionChecksum = (sessionChecksum ^ frame.checksum) * 1099511628211ull;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double p) { return sorted[std::max((size_t)std::ceil(sorted.size() * p), (size_t)1) - 1]; };
+
+    double wallSeconds = (m_WallEndMs - m_WallStartMs) / 1000.0;
+    double average = 0.0;
+    for (double ms : sorted)
+        average += ms;
+    average /= sorted.size();
+
+    out << std::fixed << std::setprecision(2)
+        << "[Replay] " << m_Frames.size() << " frames, " << m_Duration << " s of session in " << wallSeconds << " s ("
+        << (wallSeconds > 0.0 ? m_Duration / wallSeconds : 0.0) << "x real time)" << std::endl;
+    out << std::setprecision(3)
+        << "[Replay] frame ms  " << sorted.front() << " min  " << average << " avg  " << percentile(0.5) << " p50  "
+        << percentile(0.99) << " p99  " << sorted.back() << " max" << std::endl;
+    if (checksums)
+        out << "[Replay] checksum " << std::hex << std::setw(16) << std::setfill('0') << sessionChecksum << std::dec << std::setfill(' ')
+            << " over every frame" << std::endl;
+}
+
+bool SessionReplay::WriteFrames(const std::string& path) const
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "[Replay] Couldn't write " << path << std::endl;
+        return false;
+    }
+
+    out << "frame,time_s,frame_ms,checksum\n" << std::fixed;
+    for (const FrameRecord& frame : m_Frames)
+    {
+        out << frame.index << ',' << std::setprecision(4) << frame.time << ',' << frame.frameMs << ','
+            << std::hex << std::setw(16) << std::setfill('0') << frame.checksum << std::dec << std::setfill(' ') << '\n';
+    }
+    std::cout << "[Replay] " << m_Frames.size() << " frames written to " << path << std::endl;
+    return true;
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "Application.h"
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+// What a session file holds: everything that starts a notification or a
+// pulse, with the time it happened. Files are "NSES" + version + the app
+// time the session started, then the events in order, the last one is End.
+// Values are written as they are in memory (little endian).
+enum class SessionEventKind : uint8_t
+{
+    Notify,     // NotifyMessage()
+    GlowPulse,  // the glow pulse was switched on or off
+    PulseText,  // StartPulseText()
+    End         // its time is the length of the session
+};
+
+struct SessionEvent
+{
+    SessionEventKind kind = SessionEventKind::End;
+    double time = 0.0;      // seconds since the session started
+    NotifyData notify;      // Notify
+    NotifyText text;        // PulseText
+    bool on = false;        // GlowPulse
+};
+
+// Writes the events of a live session to a file as they happen
+class SessionRecorder
+{
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    // Writes the header, the session starts at startTime (app time)
+    bool Open(const std::string& path, double startTime);
+
+    void RecordNotify(double time, const NotifyData& data);
+    void RecordGlowPulse(double time, bool on);
+    void RecordPulseText(double time, std::string_view text);
+
+    // Ends the session at `time` and closes the file
+    void Close(double time);
+
+private:
+    void BeginEvent(SessionEventKind kind, double time);
+    void WriteText(std::string_view text);
+    template <typename T>
+    void Write(const T& value) { m_File.write((const char*)&value, sizeof(T)); }
+
+    std::ofstream m_File;
+    std::string m_Path;
+    double m_Start = 0.0;
+    uint32_t m_Events = 0;
+};
+
+// Plays a recorded session back on a fixed timestep, as fast as the frames
+// render. Stepping takes over GetAppTime() (SetManualAppTime), the clock
+// starts where the recording's did and only moves by the step, so every
+// replay of a file simulates the same ticks and draws the same frames.
+class SessionReplay
+{
+public:
+    // Reads the whole file
+    bool Open(const std::string& path, double step);
+
+    // Moves the clock to the next tick, false once the session is over
+    bool Step();
+    // Seconds since the session started, at the current tick
+    double GetSessionTime() const { return m_SessionTime; }
+    double GetDuration() const { return m_Duration; }
+
+    // The next event that is due at the current tick, false when none is
+    bool NextEvent(SessionEvent& event);
+
+    // Render thread, once per presented frame. checksum is 0 without checksums.
+    void AddFrame(uint64_t frameIndex, double appTime, double frameMs, uint64_t checksum);
+
+    void PrintReport(std::ostream& out) const;
+    // One CSV row per frame: index, session time, wall ms, checksum
+    bool WriteFrames(const std::string& path) const;
+
+    // FNV-1a over a frame's pixels
+    static uint64_t Checksum(const unsigned char* data, size_t size);
+
+private:
+    struct FrameRecord
+    {
+        uint64_t index;
+        double time;
+        double frameMs;
+        uint64_t checksum;
+    };
+
+    std::vector<SessionEvent> m_Events;
+    size_t m_NextEvent = 0;
+    double m_Start = 0.0;
+    double m_Step = 0.0;
+    double m_Duration = 0.0;
+    uint64_t m_Tick = 0;
+    double m_SessionTime = 0.0;
+    double m_WallStartMs = 0.0;
+    double m_WallEndMs = 0.0;
+    std::vector<FrameRecord> m_Frames;  // reserved for every tick, the render thread never grows it
+};
@@ -1,4 +1,7 @@
 #include "Shader.h"
+#include "CpuProfiler.h"
+#include "FlightRecorder.h"
+#include "GLDebug.h"
 #include <glad/glad.h>
 #include <fstream>
 #include <sstream>
@@ -10,7 +13,14 @@ Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath)
 {
     std::string vertexSrc = ReadFile(vertexPath);
     std::string fragmentSrc = ReadFile(fragmentPath);
-    m_RendererID = CreateProgram(vertexSrc, fragmentSrc);
+    m_RendererID = CreateProgram(vertexSrc, fragmentSrc, fragmentPath);
+}
+
+Shader* Shader::FromSource(std::string_view vertexSrc, std::string_view fragmentSrc, std::string_view name)
+{
+    Shader* shader = new Shader();
+    shader->m_RendererID = shader->CreateProgram(vertexSrc, fragmentSrc, name);
+    return shader;
 }
 
 Shader::~Shader()
@@ -43,11 +53,12 @@ std::string Shader::ReadFile(const std::string& path)
 }
 
 
-unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
+unsigned int Shader::CompileShader(unsigned int type, std::string_view source)
 {
     unsigned int shader = glCreateShader(type);
-    const char* src = source.c_str();
-    glShaderSource(shader, 1, &src, nullptr);
+    const char* src = source.data();
+    GLint length = (GLint)source.size();
+    glShaderSource(shader, 1, &src, &length);
     glCompileShader(shader);
 
     int success;
@@ -61,8 +72,10 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
     return shader;
 }
 
-unsigned int Shader::CreateProgram(const std::string& vs, const std::string& fs)
+unsigned int Shader::CreateProgram(std::string_view vs, std::string_view fs, std::string_view name)
 {
+    PROFILE_ZONE("Shader compile");
+    FlightMark mark("shader compile", name);
     unsigned int program = glCreateProgram();
     unsigned int vert = CompileShader(GL_VERTEX_SHADER, vs);
     unsigned int frag = CompileShader(GL_FRAGMENT_SHADER, fs);
@@ -81,48 +94,49 @@ unsigned int Shader::CreateProgram(const std::string& vs, const std::string& fs)
     {
         char info[1024];
         glGetProgramInfoLog(program, 1024, nullptr, info);
-        std::cerr << "[Shader LINK ERROR]\n" << info << std::endl;
+        std::cerr << "[Shader LINK ERROR] " << name << "\n" << info << std::endl;
     }
+    GL_CHECK("CreateProgram");
 
 
     return program;
 }
 
 
-int Shader::GetLocation(const std::string& name) const
+int Shader::GetLocation(const char* name) const
 {
-    int loc = glGetUniformLocation(m_RendererID, name.c_str());
+    int loc = glGetUniformLocation(m_RendererID, name);
     if (loc == -1)
         std::cerr << "[Shader] Uniform not found: " << name << std::endl;
     return loc;
 }
 
-void Shader::SetInt(const std::string& name, int value) const
+void Shader::SetInt(const char* name, int value) const
 {
     glUniform1i(GetLocation(name), value);
 }
 
-void Shader::SetFloat(const std::string& name, float value) const
+void Shader::SetFloat(const char* name, float value) const
 {
     glUniform1f(GetLocation(name), value);
 }
 
-void Shader::SetVec2(const std::string& name, const glm::vec2& value) const
+void Shader::SetVec2(const char* name, const glm::vec2& value) const
 {
     glUniform2f(GetLocation(name), value.x, value.y); // GLint location, GLfloat v0, GLfloat v1
 }
 
-void Shader::SetVec3(const std::string& name, const glm::vec3& value) const
+void Shader::SetVec3(const char* name, const glm::vec3& value) const
 {
     glUniform3f(GetLocation(name), value.x, value.y, value.z); // GLint location, GLfloat v0, GLfloat v1, GLfloat v2
 }
 
-void Shader::SetVec4(const std::string& name, const glm::vec4& value) const
+void Shader::SetVec4(const char* name, const glm::vec4& value) const
 {
     glUniform4f(GetLocation(name), value.x, value.y, value.z, value.w); // GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3
 }
 
-void Shader::SetMat4(const std::string& name, const glm::mat4& matrix) const
+void Shader::SetMat4(const char* name, const glm::mat4& matrix) const
 {
     glUniformMatrix4fv(
         GetLocation(name),
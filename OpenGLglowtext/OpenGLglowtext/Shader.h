@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <glm/glm.hpp>
 
 class Shader
@@ -8,22 +9,30 @@ public:
     Shader(const std::string& vertexPath, const std::string& fragmentPath);
     ~Shader();
 
+    // Build from already loaded sources (e.g. read on a worker thread).
+    // The sources don't need a terminating zero, so text straight out of
+    // the asset archive works without a copy. name shows up in errors and
+    // the hitch recorder.
+    static Shader* FromSource(std::string_view vertexSrc, std::string_view fragmentSrc, std::string_view name);
+    static std::string ReadFile(const std::string& path);
+
     void Bind() const;
     void Unbind() const;
 
-    void SetInt(const std::string& name, int value) const;
-    void SetFloat(const std::string& name, float value) const;
-    void SetVec2(const std::string& name, const glm::vec2& value) const;
-    void SetVec3(const std::string& name, const glm::vec3& value) const;
-    void SetMat4(const std::string& name, const glm::mat4& matrix) const;
-    void SetVec4(const std::string& name, const glm::vec4& value) const;
+    void SetInt(const char* name, int value) const;
+    void SetFloat(const char* name, float value) const;
+    void SetVec2(const char* name, const glm::vec2& value) const;
+    void SetVec3(const char* name, const glm::vec3& value) const;
+    void SetMat4(const char* name, const glm::mat4& matrix) const;
+    void SetVec4(const char* name, const glm::vec4& value) const;
 
 private:
-    unsigned int m_RendererID;
+    Shader() = default;
+
+    unsigned int m_RendererID = 0;
 
-    std::string ReadFile(const std::string& path);
-    unsigned int CompileShader(unsigned int type, const std::string& source);
-    unsigned int CreateProgram(const std::string& vs, const std::string& fs);
+    unsigned int CompileShader(unsigned int type, std::string_view source);
+    unsigned int CreateProgram(std::string_view vs, std::string_view fs, std::string_view name);
 
-    int GetLocation(const std::string& name) const;
+    int GetLocation(const char* name) const;
 };
@@ -0,0 +1,431 @@
+// Streams keep two pages decoded, this bounds the memory of every stream voice
+#define MA_RESOURCE_MANAGER_PAGE_SIZE_IN_MILLISECONDS 250
+#define MINIAUDIO_IMPLEMENTATION
+#include "miniaudio.h"
+
+#include "SoundBank.h"
+#include "AssetArchive.h"
+#include "CpuProfiler.h"
+#include "FlightRecorder.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+struct SoundDesc
+{
+    SoundId id;
+    int voices;             // how many instances may overlap
+    int priority;           // higher wins when the global cap is reached
+    StealPolicy steal;
+    float minRetriggerMs;   // starts closer than this are rejected
+};
+
+// Indexed by SoundId, in the order of the manifest
+static constexpr SoundDesc s_SoundDescs[] = {
+    { SoundId::MpKillstrkRadar,       3, 3, StealPolicy::Quietest, 50.0f },
+    { SoundId::MpLastStand,           3, 2, StealPolicy::Quietest, 50.0f },
+    { SoundId::UiComputerTextBlip1x,  4, 0, StealPolicy::Oldest,   20.0f },  // one per typed letter
+    { SoundId::UiComputerTextDelete1, 2, 1, StealPolicy::Oldest,   50.0f },
+};
+static_assert(std::size(s_SoundDescs) == (size_t)SoundId::Count, "Every SoundId needs a descriptor");
+
+static constexpr bool DescsInOrder()
+{
+    for (size_t i = 0; i < std::size(s_SoundDescs); i++)
+    {
+        if ((size_t)s_SoundDescs[i].id != i)
+            return false;
+    }
+    return true;
+}
+static_assert(DescsInOrder(), "s_SoundDescs has to follow the order of SoundId");
+
+static constexpr int TotalVoices()
+{
+    int total = 0;
+    for (const SoundDesc& desc : s_SoundDescs)
+        total += desc.voices;
+    return total;
+}
+static_assert(TotalVoices() <= SoundBank::kMaxVoices, "Voice pool is too small");
+
+// Read only file system over the asset archive for the resource manager.
+// A file is a cursor over the asset's bytes, so decoding a sound (or
+// paging a stream) reads the mapping instead of going through the OS.
+struct ArchiveVFS
+{
+    ma_vfs_callbacks callbacks;  // first member, miniaudio uses the VFS pointer as the callback table
+    AssetArchive* assets;
+};
+
+struct ArchiveFile
+{
+    AssetBlob blob;
+    size_t cursor = 0;
+};
+
+static ma_result ArchiveOpen(ma_vfs* vfs, const char* path, ma_uint32 openMode, ma_vfs_file* file)
+{
+    if (openMode & MA_OPEN_MODE_WRITE)
+        return MA_ACCESS_DENIED;
+
+    AssetBlob blob = ((ArchiveVFS*)vfs)->assets->Load(path);
+    if (!blob)
+        return MA_DOES_NOT_EXIST;
+    *file = new ArchiveFile{ blob };
+    return MA_SUCCESS;
+}
+
+static ma_result ArchiveOpenW(ma_vfs*, const wchar_t*, ma_uint32, ma_vfs_file*)
+{
+    return MA_NOT_IMPLEMENTED;
+}
+
+static ma_result ArchiveClose(ma_vfs*, ma_vfs_file file)
+{
+    delete (ArchiveFile*)file;
+    return MA_SUCCESS;
+}
+
+static ma_result ArchiveRead(ma_vfs*, ma_vfs_file file, void* dst, size_t bytes, size_t* bytesRead)
+{
+    ArchiveFile* f = (ArchiveFile*)file;
+    size_t count = std::min(bytes, f->blob.size - f->cursor);
+    memcpy(dst, f->blob.data + f->cursor, count);
+    f->cursor += count;
+    if (bytesRead)
+        *bytesRead = count;
+    return count == 0 && bytes > 0 ? MA_AT_END : MA_SUCCESS;
+}
+
+static ma_result ArchiveWrite(ma_vfs*, ma_vfs_file, const void*, size_t, size_t*)
+{
+    return MA_ACCESS_DENIED;
+}
+
+static ma_result ArchiveSeek(ma_vfs*, ma_vfs_file file, ma_int64 offset, ma_seek_origin origin)
+{
+    ArchiveFile* f = (ArchiveFile*)file;
+    ma_int64 base = 0;
+    if (origin == ma_seek_origin_current)
+        base = (ma_int64)f->cursor;
+    else if (origin == ma_seek_origin_end)
+        base = (ma_int64)f->blob.size;
+
+    ma_int64 target = base + offset;
+    if (target < 0 || target > (ma_int64)f->blob.size)
+        return MA_BAD_SEEK;
+    f->cursor = (size_t)target;
+    return MA_SUCCESS;
+}
+
+static ma_result ArchiveTell(ma_vfs*, ma_vfs_file file, ma_int64* cursor)
+{
+    *cursor = (ma_int64)((ArchiveFile*)file)->cursor;
+    return MA_SUCCESS;
+}
+
+static ma_result ArchiveInfo(ma_vfs*, ma_vfs_file file, ma_file_info* info)
+{
+    info->sizeInBytes = ((ArchiveFile*)file)->blob.size;
+    return MA_SUCCESS;
+}
+
+SoundBank::SoundBank()
+{
+    int first = 0;
+    for (int i = 0; i < (int)SoundId::Count; i++)
+    {
+        m_Banks[i].firstVoice = first;
+        m_Banks[i].voiceCount = s_SoundDescs[i].voices;
+        first += s_SoundDescs[i].voices;
+    }
+}
+
+SoundBank::~SoundBank()
+{
+    for (int i = 0; i < kMaxStreamVoices; i++)
+        ReleaseStream(i);
+    for (Voice& voice : m_Voices)
+    {
+        if (voice.ready)
+            ma_sound_uninit(&voice.sound);
+    }
+    for (Bank& bank : m_Banks)
+    {
+        if (bank.loaded)
+            ma_sound_uninit(&bank.source);
+    }
+    if (m_EngineReady)
+        ma_engine_uninit(&m_Engine);
+    if (m_OwnsContext)
+        ma_context_uninit(&m_Context);
+    delete m_VFS;
+}
+
+bool SoundBank::InitEngine(bool useNullBackend, AssetArchive* assets)
+{
+    ma_engine_config config = ma_engine_config_init();
+
+    m_VFS = new ArchiveVFS{ { ArchiveOpen, ArchiveOpenW, ArchiveClose, ArchiveRead, ArchiveWrite, ArchiveSeek, ArchiveTell, ArchiveInfo }, assets };
+    config.pResourceManagerVFS = m_VFS;
+
+    if (useNullBackend)
+    {
+        ma_backend backends[] = { ma_backend_null };
+        if (ma_context_init(backends, 1, NULL, &m_Context) != MA_SUCCESS)
+        {
+            std::cerr << "[Audio] Failed to init the null backend" << std::endl;
+            return false;
+        }
+        m_OwnsContext = true;
+        config.pContext = &m_Context;
+    }
+
+    if (ma_engine_init(&config, &m_Engine) != MA_SUCCESS)
+    {
+        std::cerr << "[Audio] Failed to init the engine" << std::endl;
+        return false;
+    }
+    m_EngineReady = true;
+    return true;
+}
+
+bool SoundBank::Load(SoundId id)
+{
+    if (!m_EngineReady)
+        return false;
+
+    // The VFS resolves the name in the asset archive
+    const char* path = GetAsset(id).name;
+    FlightMark mark("sound decode", path);
+    Bank& bank = m_Banks[(int)id];
+    if (ma_sound_init_from_file(&m_Engine, path, MA_SOUND_FLAG_DECODE, NULL, NULL, &bank.source) != MA_SUCCESS)
+    {
+        std::cerr << "[Audio] Failed to load: " << path << std::endl;
+        return false;
+    }
+    bank.loaded = true;
+
+    // Copies share the decoded buffer owned by the resource manager
+    for (int i = 0; i < bank.voiceCount; i++)
+    {
+        Voice& voice = m_Voices[bank.firstVoice + i];
+        voice.ready = ma_sound_init_copy(&m_Engine, &bank.source, MA_SOUND_FLAG_DECODE, NULL, &voice.sound) == MA_SUCCESS;
+        voice.priority = s_SoundDescs[(int)id].priority;
+    }
+    return true;
+}
+
+uint64_t SoundBank::GetTimeInFrames() const
+{
+    return m_EngineReady ? ma_engine_get_time_in_pcm_frames(&m_Engine) : 0;
+}
+
+uint32_t SoundBank::GetSampleRate() const
+{
+    return m_EngineReady ? ma_engine_get_sample_rate(&m_Engine) : 0;
+}
+
+bool SoundBank::Play(SoundId id)
+{
+    return PlayAt(id, 0); // a start time in the past plays right away
+}
+
+// Started (possibly with a start time in the future) and not yet finished.
+// ma_sound_is_playing() would report a scheduled voice as idle.
+static bool IsBusy(const ma_sound* sound)
+{
+    return ma_node_get_state(sound) == ma_node_state_started;
+}
+
+int SoundBank::CountActive() const
+{
+    int active = 0;
+    for (const Voice& voice : m_Voices)
+    {
+        if (voice.ready && IsBusy(&voice.sound))
+            active++;
+    }
+    for (const StreamVoice& stream : m_Streams)
+    {
+        if (stream.state == StreamState::Playing)
+            active++;
+    }
+    return active;
+}
+
+SoundBank::Voice* SoundBank::FindVictim(int first, int count, int maxPriority, StealPolicy policy)
+{
+    // Lowest priority first, then the policy decides between equals
+    Voice* victim = nullptr;
+    float victimVolume = 0.0f;
+    for (int i = first; i < first + count; i++)
+    {
+        Voice& voice = m_Voices[i];
+        if (!voice.ready || voice.priority > maxPriority || !IsBusy(&voice.sound))
+            continue;
+
+        float volume = ma_sound_get_volume(&voice.sound);
+        bool better = false;
+        if (!victim || voice.priority < victim->priority)
+            better = true;
+        else if (voice.priority == victim->priority)
+        {
+            if (policy == StealPolicy::Quietest && volume != victimVolume)
+                better = volume < victimVolume;
+            else
+                better = voice.startSerial < victim->startSerial;
+        }
+
+        if (better)
+        {
+            victim = &voice;
+            victimVolume = volume;
+        }
+    }
+    return victim;
+}
+
+bool SoundBank::PlayAt(SoundId id, uint64_t startFrame)
+{
+    PROFILE_ZONE_DETAIL("PlaySound", GetAsset(id).name);
+    Bank& bank = m_Banks[(int)id];
+    const SoundDesc& desc = s_SoundDescs[(int)id];
+    if (!bank.loaded)
+        return false;
+
+    // Retrigger throttling, measured on the engine clock
+    uint64_t start = std::max(startFrame, GetTimeInFrames());
+    uint64_t minGap = (uint64_t)(desc.minRetriggerMs * GetSampleRate() / 1000.0f);
+    if (bank.hasStarted)
+    {
+        uint64_t gap = start > bank.lastStartFrame ? start - bank.lastStartFrame : bank.lastStartFrame - start;
+        if (gap < minGap)
+        {
+            m_Rejected++;
+            return false;
+        }
+    }
+
+    Voice* pick = nullptr;
+    for (int i = 0; i < bank.voiceCount; i++)
+    {
+        Voice& voice = m_Voices[bank.firstVoice + i];
+        if (voice.ready && !IsBusy(&voice.sound))
+        {
+            pick = &voice;
+            break;
+        }
+    }
+
+    if (!pick)
+    {
+        // Per sound cap: reuse one of our own voices
+        pick = FindVictim(bank.firstVoice, bank.voiceCount, desc.priority, desc.steal);
+        if (!pick)
+        {
+            m_Rejected++;
+            return false;
+        }
+        m_Stolen++;
+    }
+    else if (CountActive() >= kMaxActiveVoices)
+    {
+        // Global cap: silence a voice of a less (or equally) important sound
+        Voice* victim = FindVictim(0, kMaxVoices, desc.priority, desc.steal);
+        if (!victim)
+        {
+            m_Rejected++;
+            return false;
+        }
+        ma_sound_stop(&victim->sound);
+        m_Stolen++;
+    }
+
+    ma_sound_stop(&pick->sound);
+    ma_sound_seek_to_pcm_frame(&pick->sound, 0);
+    ma_sound_set_start_time_in_pcm_frames(&pick->sound, startFrame);
+    ma_sound_start(&pick->sound);
+    pick->startSerial = ++m_PlaySerial;
+
+    bank.hasStarted = true;
+    bank.lastStartFrame = start;
+    m_Played++;
+    return true;
+}
+
+SoundStats SoundBank::GetStats() const
+{
+    SoundStats stats;
+    stats.active = CountActive();
+    stats.played = m_Played;
+    stats.stolen = m_Stolen;
+    stats.rejected = m_Rejected;
+    return stats;
+}
+
+void SoundBank::PrintReport(std::ostream& out) const
+{
+    SoundStats stats = GetStats();
+    out << "[Audio] voices: " << stats.active << " active, " << stats.played << " played, "
+        << stats.stolen << " stolen, " << stats.rejected << " rejected" << std::endl;
+}
+
+int SoundBank::PrefetchStream(const std::string& path)
+{
+    if (!m_EngineReady)
+        return -1;
+
+    for (int i = 0; i < kMaxStreamVoices; i++)
+    {
+        StreamVoice& stream = m_Streams[i];
+        if (stream.state != StreamState::Free)
+            continue;
+
+        FlightMark mark("stream open", path);
+        ma_uint32 flags = MA_SOUND_FLAG_STREAM | MA_SOUND_FLAG_ASYNC | MA_SOUND_FLAG_NO_SPATIALIZATION;
+        if (ma_sound_init_from_file(&m_Engine, path.c_str(), flags, NULL, NULL, &stream.sound) != MA_SUCCESS)
+        {
+            std::cerr << "[Audio] Failed to stream: " << path << std::endl;
+            return -1;
+        }
+        stream.state = StreamState::Prefetched;
+        return i;
+    }
+
+    m_Rejected++;
+    return -1;
+}
+
+bool SoundBank::PlayStream(int stream, uint64_t startFrame)
+{
+    PROFILE_ZONE("PlayStream");
+    if (stream < 0 || stream >= kMaxStreamVoices || m_Streams[stream].state != StreamState::Prefetched)
+        return false;
+
+    StreamVoice& voice = m_Streams[stream];
+    ma_sound_set_start_time_in_pcm_frames(&voice.sound, startFrame);
+    ma_sound_start(&voice.sound);
+    voice.state = StreamState::Playing;
+    m_Played++;
+    return true;
+}
+
+void SoundBank::ReleaseStream(int stream)
+{
+    if (stream < 0 || stream >= kMaxStreamVoices || m_Streams[stream].state == StreamState::Free)
+        return;
+
+    ma_sound_uninit(&m_Streams[stream].sound);
+    m_Streams[stream].state = StreamState::Free;
+}
+
+void SoundBank::Update()
+{
+    for (int i = 0; i < kMaxStreamVoices; i++)
+    {
+        if (m_Streams[i].state == StreamState::Playing && !IsBusy(&m_Streams[i].sound))
+            ReleaseStream(i);
+    }
+}
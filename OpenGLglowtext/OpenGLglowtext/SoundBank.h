@@ -0,0 +1,125 @@
+#pragma once
+#include "miniaudio.h"
+#include "AssetManifest.h"
+#include <string>
+#include <cstdint>
+#include <atomic>
+#include <ostream>
+
+class AssetArchive;
+struct ArchiveVFS;
+
+// Which voice to give up when a cap is reached
+enum class StealPolicy
+{
+    Oldest,
+    Quietest
+};
+
+struct SoundStats
+{
+    int active = 0;
+    uint64_t played = 0;
+    uint64_t stolen = 0;
+    uint64_t rejected = 0;
+};
+
+// Every notification SFX decoded into memory once, played through a fixed
+// pool of voices that are initialized up front. Play() never allocates and
+// never touches the file system.
+// Each sound is capped by its own voice count, all sounds together by
+// kMaxActiveVoices. When a cap is hit a voice of equal or lower priority is
+// stolen, retriggers closer than the sound's minimum gap are rejected.
+class SoundBank
+{
+public:
+    static constexpr int kMaxVoices = 32;
+    static constexpr int kMaxActiveVoices = 8;
+    static constexpr int kMaxStreamVoices = 2;
+
+    SoundBank();
+    ~SoundBank();
+
+    // The null backend runs the mixer without an audio device (headless boxes).
+    // Every file miniaudio opens is looked up in the asset archive, the
+    // decoders read straight from the mapped memory.
+    bool InitEngine(bool useNullBackend, AssetArchive* assets);
+
+    // Decodes the sound's asset and prepares its voices.
+    // Different ids may be loaded from different threads at the same time.
+    bool Load(SoundId id);
+
+    bool Play(SoundId id);
+    // Starts the voice at an absolute engine time (sample accurate)
+    bool PlayAt(SoundId id, uint64_t startFrame);
+
+    // Long clips (announcer lines) are streamed through the resource manager
+    // with a fixed decode buffer per voice. Prefetch starts decoding the
+    // first pages on the resource manager's job thread and returns a stream
+    // handle, or -1 when all stream voices are taken.
+    int PrefetchStream(const std::string& path);
+    bool PlayStream(int stream, uint64_t startFrame);
+    void ReleaseStream(int stream);
+
+    // Reclaims stream voices that finished playing (simulation tick)
+    void Update();
+
+    uint64_t GetTimeInFrames() const;
+    uint32_t GetSampleRate() const;
+
+    SoundStats GetStats() const;
+    void PrintReport(std::ostream& out) const;
+
+    ma_engine* GetEngine() { return &m_Engine; }
+    bool IsNullBackend() const { return m_OwnsContext; }
+
+private:
+    struct Voice
+    {
+        ma_sound sound;
+        bool ready = false;
+        int priority = 0;
+        uint64_t startSerial = 0;
+    };
+
+    struct Bank
+    {
+        ma_sound source;
+        bool loaded = false;
+        int firstVoice = 0;
+        int voiceCount = 0;
+        bool hasStarted = false;
+        uint64_t lastStartFrame = 0;
+    };
+
+    enum class StreamState
+    {
+        Free,
+        Prefetched,
+        Playing
+    };
+
+    struct StreamVoice
+    {
+        ma_sound sound;
+        StreamState state = StreamState::Free;
+    };
+
+    int CountActive() const;
+    Voice* FindVictim(int first, int count, int maxPriority, StealPolicy policy);
+
+    ma_context m_Context;
+    bool m_OwnsContext = false;
+    ArchiveVFS* m_VFS = nullptr;
+    ma_engine m_Engine;
+    bool m_EngineReady = false;
+
+    Bank m_Banks[(int)SoundId::Count];
+    Voice m_Voices[kMaxVoices];
+    StreamVoice m_Streams[kMaxStreamVoices];
+    uint64_t m_PlaySerial = 0;
+
+    std::atomic<uint64_t> m_Played = 0;
+    std::atomic<uint64_t> m_Stolen = 0;
+    std::atomic<uint64_t> m_Rejected = 0;
+};
@@ -0,0 +1,113 @@
+#pragma once
+#include "Platform.h"
+#include <algorithm>
+#include <cmath>
+
+enum class SplashPhase
+{
+    In,
+    Hold,
+    Out,
+    Finished
+};
+
+struct SplashAnim {
+    double duration = 0.15;
+    double startTime = 0.0;
+    double holdTime    = 2.0;
+    bool active = false;
+    SplashPhase phase = SplashPhase::In;
+    void Start()
+    {
+        active = true;
+        phase = SplashPhase::In;
+        startTime = GetAppTime();
+    }
+    bool WantsToFinish() const
+    {
+        return phase == SplashPhase::Hold &&
+            (GetAppTime() - startTime) >= holdTime;
+    }
+    double EaseOut(double t)
+    {return 1.0 - pow(1.0 - t, 3.0);}
+    double GetValue(double from, double to) {
+        double now = GetAppTime();
+        double elapsed = now - startTime;
+        switch (phase)
+        {
+        case SplashPhase::In:
+        {
+            double t = std::min(elapsed / duration, to);
+            if (t >= to)
+            {
+                phase = SplashPhase::Hold;
+                startTime = now;
+            }
+            return from + EaseOut(t) * (to - from);
+        }
+        case SplashPhase::Hold:
+        {
+            if (elapsed >= holdTime)
+            {
+                    phase = SplashPhase::Out;
+                    startTime = now;
+            }
+            return to;
+        }
+        case SplashPhase::Out:
+        {
+            double t = std::min(elapsed / duration, to);
+            if (t >= to)
+            {
+                phase = SplashPhase::Finished;
+                active = false;
+            }
+            return to + EaseOut(t) * (from - to);
+        }
+        default:
+            return 0.0;
+        }
+    }
+
+    void Update() {
+        if (!active) return;
+        double elapsed = GetAppTime() - startTime;
+        if (elapsed >= (phase == SplashPhase::Hold ? holdTime : duration)) {
+            if (phase == SplashPhase::In) {
+                phase = SplashPhase::Hold;
+                startTime = GetAppTime();
+            } else if (phase == SplashPhase::Hold) {
+                phase = SplashPhase::Out;
+                startTime = GetAppTime();
+            } else if (phase == SplashPhase::Out) {
+                phase = SplashPhase::Finished;
+                active = false;
+            }
+        }
+    }
+
+    double GetProgress() {
+        double elapsed = GetAppTime() - startTime;
+        return std::min(elapsed / duration, 1.0);
+    }
+
+    double GetAlphaMW2() {
+        double t = GetProgress();
+        if (phase == SplashPhase::In)   return std::min(t * 2.0, 1.0);
+        if (phase == SplashPhase::Hold) return 1.0;
+        if (phase == SplashPhase::Out)  return 1.0 - t;
+        return 0.0;
+    }
+
+    double GetSlideMW2(double offset) {
+        double t = EaseOut(GetProgress());
+        if (phase == SplashPhase::In)   return -offset + (t * offset);
+        if (phase == SplashPhase::Hold) return 0.0;
+        if (phase == SplashPhase::Out)  return t * offset;
+        return 0.0;
+    }
+    bool IsFinished() const
+    {return phase == SplashPhase::Finished;}
+    bool IsEnding() const
+    {return phase == SplashPhase::Out;}
+};
@@ -0,0 +1,69 @@
+#include "StartupReport.h"
+#include "FlightRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+// Taken during static initialization, as close to process start as it gets
+static const std::chrono::steady_clock::time_point s_ProcessStart = std::chrono::steady_clock::now();
+
+double StartupReport::Now()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - s_ProcessStart).count();
+}
+
+void StartupReport::MarkFirstFrame()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_FirstFrame < 0.0)
+        m_FirstFrame = Now();
+}
+
+void StartupReport::MarkNotifyRequested()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_NotifyRequested < 0.0)
+        m_NotifyRequested = Now();
+}
+
+void StartupReport::MarkNotifyShown()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_NotifyShown < 0.0)
+        m_NotifyShown = Now();
+}
+
+bool StartupReport::HasFirstFrame() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_FirstFrame >= 0.0;
+}
+
+void StartupReport::AddInit(const std::string& name, InitTrigger trigger, double startMs, double endMs)
+{
+    FlightRecorder::Mark(trigger == InitTrigger::FirstUse ? "first use" : "idle load", name, startMs, endMs - startMs);
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Inits.push_back({ name, trigger, startMs, endMs });
+}
+
+void StartupReport::PrintReport(std::ostream& out) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    out << std::fixed << std::setprecision(2);
+    if (m_FirstFrame >= 0.0)
+        out << "[Startup] time to first frame: " << m_FirstFrame << " ms" << std::endl;
+    if (m_NotifyShown >= 0.0)
+    {
+        out << "[Startup] time to first notification: " << m_NotifyShown << " ms (requested at "
+            << m_NotifyRequested << " ms, on screen " << m_NotifyShown - m_NotifyRequested << " ms later)" << std::endl;
+    }
+
+    std::vector<Init> inits = m_Inits;
+    std::sort(inits.begin(), inits.end(), [](const Init& a, const Init& b) { return a.startMs < b.startMs; });
+    for (const Init& init : inits)
+    {
+        out << "[Startup] " << std::setw(8) << init.startMs << " ms  " << std::setw(7) << (init.endMs - init.startMs)
+            << " ms  " << std::setw(9) << (init.trigger == InitTrigger::Idle ? "idle" : "first use") << "  " << init.name << std::endl;
+    }
+}
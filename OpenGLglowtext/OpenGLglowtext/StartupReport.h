@@ -0,0 +1,47 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <mutex>
+#include <ostream>
+
+// What made a lazily initialized subsystem load
+enum class InitTrigger
+{
+    FirstUse,  // needed right now, the caller waited for it
+    Idle       // warmed from the idle prefetch list
+};
+
+// When the first frame and the first notification reached the screen, and
+// when each lazily initialized subsystem was loaded and why. Times are in
+// ms since process start. Thread safe.
+class StartupReport
+{
+public:
+    static double Now();
+
+    // Only the first call of each is kept
+    void MarkFirstFrame();
+    void MarkNotifyRequested();
+    void MarkNotifyShown();
+
+    bool HasFirstFrame() const;
+
+    void AddInit(const std::string& name, InitTrigger trigger, double startMs, double endMs);
+
+    void PrintReport(std::ostream& out) const;
+
+private:
+    struct Init
+    {
+        std::string name;
+        InitTrigger trigger;
+        double startMs;
+        double endMs;
+    };
+
+    mutable std::mutex m_Mutex;
+    double m_FirstFrame = -1.0;
+    double m_NotifyRequested = -1.0;
+    double m_NotifyShown = -1.0;
+    std::vector<Init> m_Inits;
+};
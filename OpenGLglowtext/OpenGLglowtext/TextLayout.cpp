@@ -0,0 +1,111 @@
+#include "TextLayout.h"
+#include "FontRaster.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+std::map<char, Character> BuildCharacters(const TextureData& atlas, GLuint texture)
+{
+    std::map<char, Character> characters;
+    for (const TexGlyph& glyph : atlas.glyphs)
+    {
+        if (glyph.layer < 0)
+        {
+        	// space or empty glyph
+            characters[(char)glyph.code] = {
+                0,
+                { 0, 0 },
+                { glyph.left, glyph.top },
+                (GLuint)(glyph.advance >> 6)
+            };
+            continue;
+        }
+
+        characters[(char)glyph.code] = {
+            texture,
+            { glyph.width, glyph.height },
+            { glyph.left, glyph.top },
+            (GLuint)glyph.advance,
+            glyph.layer,
+            { kGlyphMargin / (float)atlas.width, kGlyphMargin / (float)atlas.height },
+            { glyph.width / (float)atlas.width, glyph.height / (float)atlas.height }
+        };
+    }
+    return characters;
+}
+
+glm::vec2 MeasureText(const std::map<char, Character>& font, std::string_view text, float scale, bool skipColorCodes)
+{
+    float width = 0.0f;
+    float maxHeight = 0.0f;
+
+    for (size_t i = 0; i < text.length(); ++i)
+    {
+        if (skipColorCodes && text[i] == '^' && i + 1 < text.length())
+        {
+            i++;
+            continue;
+        }
+        auto it = font.find(text[i]);
+        if (it == font.end())
+            continue;
+        width += (it->second.Advance >> 6) * scale;
+        maxHeight = std::max(maxHeight, it->second.Size.y * scale);
+    }
+    return { width, maxHeight };
+}
+
+glm::vec3 ColorCodeColor(char code, const glm::vec3& current)
+{
+    switch (code)
+    {
+        case '1': return { 1.0f, 0.2f, 0.2f }; // Red
+        case '2': return { 0.2f, 1.0f, 0.2f }; // Green
+        case '3': return { 1.0f, 1.0f, 0.0f }; // Yellow
+        case '4': return { 0.0f, 0.0f, 1.0f }; // Blue
+        case '5': return { 0.0f, 1.0f, 1.0f }; // Cyan
+        case '6': return { 0.8f, 0.2f, 0.5f }; // pink/Magenta
+        case '7': return { 1.0f, 1.0f, 1.0f }; // White
+        case '0': return { 0.0f, 0.0f, 0.0f }; // Black
+        default:  return current;
+    }
+}
+
+void BuildDecayOrder(std::span<int> indices, uint32_t seed, std::vector<DecayEntry>& order)
+{
+    float decayStepTime = 0.12f; // 0.12f = MW2 ~100–150ms
+    int   decayBatchMin = 2;
+    int   decayBatchMax = 3;
+
+    order.clear();
+    std::iota(indices.begin(), indices.end(), 0);
+    std::mt19937 rng(seed);
+    std::shuffle(indices.begin(), indices.end(), rng);
+
+    float t = 0.0f;
+    size_t i = 0;
+
+    while (i < indices.size())
+    {
+        int batch = rng() % (decayBatchMax - decayBatchMin + 1) + decayBatchMin;
+
+        for (int b = 0; b < batch && i < indices.size(); b++, i++)
+        {
+            order.push_back({
+                indices[i],
+                t + ((rng() % 30) / 1000.0f) // 0–30ms jitter
+            });
+        }
+        t += decayStepTime;
+    }
+}
+
+const DecayEntry* FindDecayEntry(std::span<const DecayEntry> order, int index)
+{
+    for (const DecayEntry& entry : order)
+    {
+        if (entry.index == index)
+            return &entry;
+    }
+    return nullptr;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "FramePacket.h"
+#include "TextureFile.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <map>
+#include <span>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+struct Character
+{
+    GLuint TextureID;   // the font's glyph array, 0 for empty glyphs
+    glm::ivec2 Size;
+    glm::ivec2 Bearing;
+    GLuint Advance;
+    int Layer = 0;
+    glm::vec2 UVOrigin = glm::vec2(0.0f); // glyph rect inside its layer
+    glm::vec2 UVSize = glm::vec2(0.0f);
+};
+
+// The CPU side of text: glyph metrics, measuring, color codes and the
+// typewriter's decay schedule. None of it needs a GL context, the renderer
+// and the microbenchmarks share it.
+
+// The glyph set of an atlas built by BuildGlyphAtlas / cooked by AssetCook,
+// texture is the array it was uploaded to
+std::map<char, Character> BuildCharacters(const TextureData& atlas, GLuint texture);
+
+// Size of text at scale, glyphs the font doesn't have count as nothing.
+// skipColorCodes leaves out ^N pairs, like they are drawn.
+glm::vec2 MeasureText(const std::map<char, Character>& font, std::string_view text, float scale, bool skipColorCodes);
+
+// Color of a ^N code, current for an unknown one
+glm::vec3 ColorCodeColor(char code, const glm::vec3& current);
+
+// Places every drawn glyph of text with ^N color codes, starting at x on
+// baseline y: emit(character, x, y, width, height, color) per glyph
+template <typename Emit>
+void LayoutColoredText(const std::map<char, Character>& font, std::string_view text, float x, float y, float scale, float alpha, Emit&& emit)
+{
+    glm::vec3 currentColor(1.0f);
+    for (size_t i = 0; i < text.length(); ++i)
+    {
+        if (text[i] == '^' && i + 1 < text.length())
+        {
+            currentColor = ColorCodeColor(text[++i], currentColor);
+            continue;
+        }
+        auto it = font.find(text[i]);
+        if (it == font.end())
+            continue;
+        const Character& ch = it->second;
+        if (ch.TextureID == 0) // space / empty glyph
+        {
+            x += ch.Advance * scale;
+            continue;
+        }
+
+        float xpos = x + ch.Bearing.x * scale;
+        float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
+        emit(ch, xpos, ypos, ch.Size.x * scale, ch.Size.y * scale, currentColor * alpha);
+        x += (ch.Advance >> 6) * scale;
+    }
+}
+
+// When each letter of the typewriter text decays: the letters of indices
+// (0..n-1, shuffled here) go in batches of 2-3 every 120 ms, with up to
+// 30 ms of jitter. The same seed gives the same order.
+void BuildDecayOrder(std::span<int> indices, uint32_t seed, std::vector<DecayEntry>& order);
+
+// The entry of a letter, null when it isn't in the order
+const DecayEntry* FindDecayEntry(std::span<const DecayEntry> order, int index);
@@ -0,0 +1,187 @@
+#include "TextureFile.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+#include "stb_image.h"
+
+// On disk: header, glyph table, pixels (same layout as TextureData)
+struct TexFileHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t format;
+    int32_t  width;
+    int32_t  height;
+    int32_t  layers;
+    int32_t  levels;
+    uint32_t glyphCount;
+    uint64_t dataSize;
+};
+
+static const char kTexMagic[4] = { 'G', 'T', 'E', 'X' };
+static const uint32_t kTexVersion = 1;
+
+bool IsBlockFormat(TexFormat format)
+{
+    return format == TexFormat::BC4 || format == TexFormat::BC7;
+}
+
+size_t TexLayerSize(TexFormat format, int width, int height)
+{
+    size_t blocks = (size_t)((width + 3) / 4) * ((height + 3) / 4);
+    switch (format)
+    {
+        case TexFormat::RGBA8: return (size_t)width * height * 4;
+        case TexFormat::R8:    return (size_t)width * height;
+        case TexFormat::BC4:   return blocks * 8;
+        case TexFormat::BC7:   return blocks * 16;
+    }
+    return 0;
+}
+
+size_t TexLevelOffset(const TextureData& tex, int level, int layer)
+{
+    size_t offset = 0;
+    for (int l = 0; l < level; l++)
+        offset += TexLayerSize(tex.format, std::max(tex.width >> l, 1), std::max(tex.height >> l, 1)) * tex.layers;
+    return offset + TexLayerSize(tex.format, std::max(tex.width >> level, 1), std::max(tex.height >> level, 1)) * layer;
+}
+
+size_t TexTotalSize(const TextureData& tex)
+{
+    return TexLevelOffset(tex, tex.levels, 0);
+}
+
+bool ReadTextureFile(const unsigned char* data, size_t size, TextureData& tex)
+{
+    TexFileHeader header{};
+    if (size < sizeof(header))
+        return false;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, kTexMagic, 4) != 0 || header.version != kTexVersion)
+    {
+        std::cerr << "[Texture] Not a cooked texture (or an old one)" << std::endl;
+        return false;
+    }
+
+    tex.format = (TexFormat)header.format;
+    tex.width  = header.width;
+    tex.height = header.height;
+    tex.layers = header.layers;
+    tex.levels = header.levels;
+    size_t glyphBytes = sizeof(TexGlyph) * header.glyphCount;
+    if (header.dataSize != TexTotalSize(tex) || size - sizeof(header) < glyphBytes + header.dataSize)
+    {
+        std::cerr << "[Texture] Size mismatch in a cooked texture" << std::endl;
+        return false;
+    }
+
+    tex.glyphs.resize(header.glyphCount);
+    memcpy(tex.glyphs.data(), data + sizeof(header), glyphBytes);
+    tex.pixels.clear();
+    tex.view = data + sizeof(header) + glyphBytes;
+    return true;
+}
+
+bool WriteTextureFile(const std::string& path, const TextureData& tex)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    TexFileHeader header{};
+    memcpy(header.magic, kTexMagic, 4);
+    header.version    = kTexVersion;
+    header.format     = (uint32_t)tex.format;
+    header.width      = tex.width;
+    header.height     = tex.height;
+    header.layers     = tex.layers;
+    header.levels     = tex.levels;
+    header.glyphCount = (uint32_t)tex.glyphs.size();
+    header.dataSize   = TexTotalSize(tex);
+
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)tex.glyphs.data(), sizeof(TexGlyph) * tex.glyphs.size());
+    file.write((const char*)tex.Data(), header.dataSize);
+    return (bool)file;
+}
+
+std::string CookedName(const std::string& file)
+{
+    return "cooked/" + file + ".gtex";
+}
+
+TextureData DecodeIcon(const unsigned char* data, size_t bytes, int size)
+{
+    TextureData image;
+
+    int width, height, components;
+    stbi_set_flip_vertically_on_load_thread(true);
+    // Expand grey / RGB files to RGBA so every layer uses the same format
+    unsigned char* src = stbi_load_from_memory(data, (int)bytes, &width, &height, &components, 4);
+    if (!src)
+        return image;
+
+    image.format = TexFormat::RGBA8;
+    image.width = size;
+    image.height = size;
+    image.levels = 0;
+    for (int s = size; s >= 1; s >>= 1)
+        image.levels++;
+    image.pixels.resize(TexTotalSize(image));
+
+    // Bilinear resample into level 0
+    unsigned char* dst = image.pixels.data();
+    if (width == size && height == size)
+    {
+        memcpy(dst, src, (size_t)size * size * 4);
+    }
+    else
+    {
+        for (int y = 0; y < size; y++)
+        {
+            float sy = std::clamp((y + 0.5f) * height / size - 0.5f, 0.0f, (float)(height - 1));
+            int y0 = (int)sy;
+            int y1 = std::min(y0 + 1, height - 1);
+            float fy = sy - y0;
+            for (int x = 0; x < size; x++)
+            {
+                float sx = std::clamp((x + 0.5f) * width / size - 0.5f, 0.0f, (float)(width - 1));
+                int x0 = (int)sx;
+                int x1 = std::min(x0 + 1, width - 1);
+                float fx = sx - x0;
+                for (int c = 0; c < 4; c++)
+                {
+                    float top = src[(y0 * width + x0) * 4 + c] * (1.0f - fx) + src[(y0 * width + x1) * 4 + c] * fx;
+                    float bottom = src[(y1 * width + x0) * 4 + c] * (1.0f - fx) + src[(y1 * width + x1) * 4 + c] * fx;
+                    dst[(y * size + x) * 4 + c] = (unsigned char)(top * (1.0f - fy) + bottom * fy + 0.5f);
+                }
+            }
+        }
+    }
+    stbi_image_free(src);
+
+    // 2x2 box filter for every further level
+    for (int level = 1; level < image.levels; level++)
+    {
+        const unsigned char* prev = image.pixels.data() + TexLevelOffset(image, level - 1, 0);
+        unsigned char* next = image.pixels.data() + TexLevelOffset(image, level, 0);
+        int s = size >> level;
+        int ps = s * 2;
+        for (int y = 0; y < s; y++)
+        {
+            for (int x = 0; x < s; x++)
+            {
+                for (int c = 0; c < 4; c++)
+                {
+                    int sum = prev[((y * 2) * ps + x * 2) * 4 + c] + prev[((y * 2) * ps + x * 2 + 1) * 4 + c]
+                            + prev[((y * 2 + 1) * ps + x * 2) * 4 + c] + prev[((y * 2 + 1) * ps + x * 2 + 1) * 4 + c];
+                    next[(y * s + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+                }
+            }
+        }
+    }
+    return image;
+}
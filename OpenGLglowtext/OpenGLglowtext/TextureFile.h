@@ -0,0 +1,68 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Icons are resampled to this size, the layer size of the icon array
+static constexpr int kIconLayerSize = 128;
+
+// Pixel layout of a texture blob. Block formats store 4x4 texel blocks,
+// levels smaller than a block still take one whole block.
+enum class TexFormat : uint32_t
+{
+    RGBA8,
+    R8,
+    BC4,  // one channel, 8 bytes per block (glyphs)
+    BC7   // RGBA, 16 bytes per block (icons)
+};
+
+// Metrics of one glyph of a font atlas, layer -1 for empty glyphs (space)
+struct TexGlyph
+{
+    int32_t code;
+    int32_t layer;
+    int32_t width;
+    int32_t height;
+    int32_t left;
+    int32_t top;
+    int32_t advance;  // 1/64 pixels
+};
+
+// Any number of equally sized layers with a mip chain.
+// Pixels are level major: level 0 of every layer, then level 1 and so on.
+struct TextureData
+{
+    TexFormat format = TexFormat::RGBA8;
+    int width = 0;
+    int height = 0;
+    int layers = 1;
+    int levels = 1;
+    std::vector<TexGlyph> glyphs;  // font atlases only
+    std::vector<unsigned char> pixels;
+    // Set instead of pixels when the data is read in place from a mapped file
+    const unsigned char* view = nullptr;
+
+    const unsigned char* Data() const { return view ? view : pixels.data(); }
+    bool IsEmpty() const { return pixels.empty() && !view; }
+};
+
+bool IsBlockFormat(TexFormat format);
+// Bytes of one layer of a level that is width x height texels
+size_t TexLayerSize(TexFormat format, int width, int height);
+size_t TexLevelOffset(const TextureData& tex, int level, int layer);
+size_t TexTotalSize(const TextureData& tex);
+
+// Parses a cooked file in memory. The pixels aren't copied, tex.view
+// points into data, which has to outlive tex.
+bool ReadTextureFile(const unsigned char* data, size_t size, TextureData& tex);
+bool WriteTextureFile(const std::string& path, const TextureData& tex);
+
+// Where AssetCook puts the cooked version of an asset file, relative to
+// the assets folder
+std::string CookedName(const std::string& file);
+
+// CPU only, safe to run on any thread. Decodes an encoded image (png, ...)
+// to RGBA8, resamples to size x size and builds a box filtered mip chain
+// down to 1x1. Rows are stored bottom first, the way GL expects them.
+TextureData DecodeIcon(const unsigned char* data, size_t bytes, int size);
@@ -0,0 +1,286 @@
+#include "TextureLoader.h"
+#include "JobSystem.h"
+#include "AssetArchive.h"
+#include "CpuProfiler.h"
+#include "FlightRecorder.h"
+#include "GLDebug.h"
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <thread>
+#include <chrono>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+TextureLoader::TextureLoader(JobSystem* jobs, AssetArchive* assets)
+    : m_Jobs(jobs), m_Assets(assets)
+{
+}
+
+TextureLoader::~TextureLoader()
+{
+    for (Slot& slot : m_Slots)
+    {
+        if (slot.fence)
+            glDeleteSync(slot.fence);
+        if (slot.pbo)
+            glDeleteBuffers(1, &slot.pbo);
+    }
+    glDeleteTextures(1, &m_IconArray);
+}
+
+GLenum TextureLoader::GetInternalFormat(TexFormat format)
+{
+    switch (format)
+    {
+        case TexFormat::RGBA8: return GL_RGBA8;
+        case TexFormat::R8:    return GL_R8;
+        case TexFormat::BC4:   return GL_COMPRESSED_RED_RGTC1;
+        case TexFormat::BC7:   return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    }
+    return GL_RGBA8;
+}
+
+bool TextureLoader::IsSupported(TexFormat format)
+{
+    GLint supported = GL_FALSE;
+    glGetInternalformativ(GL_TEXTURE_2D_ARRAY, GetInternalFormat(format), GL_INTERNALFORMAT_SUPPORTED, 1, &supported);
+    return supported == GL_TRUE;
+}
+
+void TextureLoader::UploadLevels(GLuint texture, const TextureData& data, int layer, const unsigned char* pixels)
+{
+    // Level major layout: all layers of one level are a single contiguous upload
+    for (int level = 0; level < data.levels; level++)
+    {
+        int width = std::max(data.width >> level, 1);
+        int height = std::max(data.height >> level, 1);
+        size_t offset = TexLevelOffset(data, level, 0);
+        const void* src = pixels ? (const void*)(pixels + offset) : (const void*)offset;
+
+        if (IsBlockFormat(data.format))
+        {
+            GLsizei size = (GLsizei)(TexLayerSize(data.format, width, height) * data.layers);
+            glCompressedTextureSubImage3D(texture, level, 0, 0, layer, width, height, data.layers,
+                GetInternalFormat(data.format), size, src);
+        }
+        else
+        {
+            GLenum format = data.format == TexFormat::R8 ? GL_RED : GL_RGBA;
+            glTextureSubImage3D(texture, level, 0, 0, layer, width, height, data.layers,
+                format, GL_UNSIGNED_BYTE, src);
+        }
+    }
+}
+
+void TextureLoader::Init()
+{
+    // The array has a single format, so BC7 only if every icon has been cooked
+    m_Format = TexFormat::RGBA8;
+    if (IsSupported(TexFormat::BC7))
+    {
+        bool allCooked = true;
+        for (const AssetRef& icon : kIconAssets)
+            allCooked = allCooked && m_Assets->Contains("assets/" + CookedName(icon.File()));
+        if (allCooked)
+            m_Format = TexFormat::BC7;
+    }
+
+    m_Levels = 1;
+    for (int size = kIconLayerSize; size > 1; size >>= 1)
+        m_Levels++;
+
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_IconArray);
+    glTextureStorage3D(m_IconArray, m_Levels, GetInternalFormat(m_Format), kIconLayerSize, kIconLayerSize, (int)IconId::Count);
+    glTextureParameteri(m_IconArray, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_IconArray, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_IconArray, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTextureParameteri(m_IconArray, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Fully transparent, an icon that is still loading just isn't there yet.
+    // Compressed storage can't be cleared, so upload blank blocks instead.
+    TextureData blank;
+    blank.format = m_Format;
+    blank.width = kIconLayerSize;
+    blank.height = kIconLayerSize;
+    blank.layers = (int)IconId::Count;
+    blank.levels = m_Levels;
+    blank.pixels.assign(TexTotalSize(blank), 0);
+    if (m_Format == TexFormat::BC7)
+    {
+        // Mode 6 block with all endpoints at zero
+        for (size_t i = 0; i < blank.pixels.size(); i += 16)
+            blank.pixels[i] = 0x40;
+    }
+    UploadLevels(m_IconArray, blank, 0, blank.pixels.data());
+
+    std::cout << "[Texture] icon array: " << (m_Format == TexFormat::BC7 ? "BC7 (cooked)" : "RGBA8") << std::endl;
+}
+
+void TextureLoader::Request(IconId id, int priority)
+{
+    if (id == IconId::None)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Slot& slot = m_Slots[(int)id];
+    slot.priority = std::max(slot.priority, priority);
+    if (slot.state == SlotState::Unrequested)
+    {
+        slot.state = SlotState::Pending;
+        StartDecodes();
+    }
+}
+
+int TextureLoader::PickHighest(SlotState state) const
+{
+    int best = -1;
+    for (int i = 0; i < (int)IconId::Count; i++)
+    {
+        if (m_Slots[i].state != state)
+            continue;
+        if (best < 0 || m_Slots[i].priority > m_Slots[best].priority)
+            best = i;
+    }
+    return best;
+}
+
+void TextureLoader::StartDecodes()
+{
+    while (m_DecodesInFlight < kMaxDecodesInFlight)
+    {
+        int layer = PickHighest(SlotState::Pending);
+        if (layer < 0)
+            return;
+
+        m_Slots[layer].state = SlotState::Decoding;
+        m_DecodesInFlight++;
+
+        const AssetRef& icon = GetAsset((IconId)layer);
+        std::string file = icon.File();
+        bool cooked = m_Format == TexFormat::BC7;
+
+        m_Jobs->Submit(("load " + file).c_str(), [this, &icon, file, layer, cooked] {
+            PROFILE_ZONE_DETAIL("LoadTexture", icon.name);
+            FlightMark mark("icon decode", icon.name);
+            // Cooked blocks stay a view into the archive until they go into the upload buffer
+            AssetBlob blob = cooked ? m_Assets->Load("assets/" + CookedName(file)) : m_Assets->Load(icon);
+            TextureData image;
+            if (blob && !cooked)
+                image = DecodeIcon(blob.data, blob.size, kIconLayerSize);
+            else if (blob && ReadTextureFile(blob.data, blob.size, image) && (image.format != TexFormat::BC7 || image.width != kIconLayerSize
+                || image.height != kIconLayerSize || image.layers != 1 || image.levels != m_Levels))
+            {
+                std::cerr << "[Texture] Cooked icon doesn't match the icon array, cook again: " << file << std::endl;
+                image = {};
+            }
+            if (image.IsEmpty())
+                std::cerr << "[Texture] Failed to load: " << file << std::endl;
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            Slot& done = m_Slots[layer];
+            done.state = image.IsEmpty() ? SlotState::Failed : SlotState::Decoded;
+            done.image = std::move(image);
+            m_DecodesInFlight--;
+            StartDecodes();
+        });
+    }
+}
+
+void TextureLoader::BeginUpload(int layer, Slot& slot)
+{
+    PROFILE_ZONE_DETAIL("UploadTexture", GetAsset((IconId)layer).name);
+    FlightMark mark("icon upload", GetAsset((IconId)layer).name);
+    TextureData& image = slot.image;
+
+    // The pixels go into a buffer first, the copies into the array run on the GPU timeline
+    glCreateBuffers(1, &slot.pbo);
+    glNamedBufferStorage(slot.pbo, (GLsizeiptr)TexTotalSize(image), image.Data(), 0);
+    image.pixels = {};
+    image.view = nullptr;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.pbo);
+    UploadLevels(m_IconArray, image, layer, nullptr);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    GL_CHECK("BeginUpload");
+}
+
+void TextureLoader::Update()
+{
+    // Pick the work under the lock, issue the GL calls without it so
+    // Request() from the simulation thread never waits on the driver
+    int uploads[kMaxUploadsPerFrame];
+    int uploadCount = 0;
+    int inFlight[(int)IconId::Count];
+    int inFlightCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (int i = 0; i < (int)IconId::Count; i++)
+        {
+            if (m_Slots[i].state == SlotState::Uploading)
+                inFlight[inFlightCount++] = i;
+        }
+        while (uploadCount < kMaxUploadsPerFrame)
+        {
+            int layer = PickHighest(SlotState::Decoded);
+            if (layer < 0)
+                break;
+            m_Slots[layer].state = SlotState::Uploading;
+            uploads[uploadCount++] = layer;
+        }
+    }
+
+    for (int i = 0; i < uploadCount; i++)
+        BeginUpload(uploads[i], m_Slots[uploads[i]]);
+
+    for (int i = 0; i < inFlightCount; i++)
+    {
+        Slot& slot = m_Slots[inFlight[i]];
+        GLenum status = glClientWaitSync(slot.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            continue;
+
+        glDeleteSync(slot.fence);
+        glDeleteBuffers(1, &slot.pbo);
+        slot.fence = nullptr;
+        slot.pbo = 0;
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        slot.state = SlotState::Ready;
+    }
+}
+
+void TextureLoader::Finish()
+{
+    while (true)
+    {
+        Update();
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            bool busy = false;
+            for (const Slot& slot : m_Slots)
+            {
+                if (slot.state != SlotState::Unrequested && slot.state != SlotState::Ready && slot.state != SlotState::Failed)
+                    busy = true;
+            }
+            if (!busy)
+                return;
+        }
+        // Update polls the fences without flushing, a fence still sitting in
+        // the command queue would never signal
+        glFlush();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+bool TextureLoader::IsReady(IconId id) const
+{
+    if (id == IconId::None)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Slots[(int)id].state == SlotState::Ready;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "TextureFile.h"
+#include "AssetManifest.h"
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <mutex>
+
+class JobSystem;
+class AssetArchive;
+
+// Asynchronous icon streaming into the icon texture array.
+// Request() returns at once, the icon is read on a JobSystem worker (the
+// BC7 file cooked by AssetCook straight out of the asset archive, or the
+// PNG decoded, resized and mipmapped when there is none) and uploaded on the render thread through a pixel
+// unpack buffer. A fence tells when the copy finished. Layers start out
+// transparent, so an icon that is still loading draws as nothing instead
+// of stalling the frame.
+// Every png of the manifest is one layer of the array, the IconId is the
+// layer index.
+class TextureLoader
+{
+public:
+    static constexpr int kMaxDecodesInFlight = 2;
+    static constexpr int kMaxUploadsPerFrame = 2;
+
+    TextureLoader(JobSystem* jobs, AssetArchive* assets);
+    // Needs the GL context, in-flight decodes must be finished (JobSystem::WaitAll)
+    ~TextureLoader();
+
+    // Needs the GL context. Creates the transparent icon array, BC7 when the
+    // driver supports it and every icon has been cooked, RGBA8 otherwise.
+    void Init();
+
+    // Any thread. Requesting an icon twice only raises its priority.
+    void Request(IconId id, int priority = 0);
+
+    // Render thread, once per frame: starts uploads and retires finished ones
+    void Update();
+    // Render thread. Blocks until every requested icon is resident (or
+    // failed), for runs whose frames may not depend on streaming (replays).
+    void Finish();
+
+    GLuint GetIconArray() const { return m_IconArray; }
+    TexFormat GetIconFormat() const { return m_Format; }
+    bool IsReady(IconId id) const;
+
+    // Needs the GL context
+    static GLenum GetInternalFormat(TexFormat format);
+    static bool IsSupported(TexFormat format);
+    // Uploads every level of data into layers [layer, layer + data.layers).
+    // pixels == nullptr reads from the bound GL_PIXEL_UNPACK_BUFFER instead.
+    static void UploadLevels(GLuint texture, const TextureData& data, int layer, const unsigned char* pixels);
+
+private:
+    enum class SlotState
+    {
+        Unrequested,
+        Pending,    // waiting for a decode job
+        Decoding,
+        Decoded,    // pixels in memory, waiting for the render thread
+        Uploading,  // copy from the PBO issued, fence not signaled yet
+        Ready,
+        Failed
+    };
+
+    struct Slot
+    {
+        int priority = 0;
+        SlotState state = SlotState::Unrequested;
+        TextureData image;
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+    };
+
+    void StartDecodes();  // m_Mutex held
+    void BeginUpload(int layer, Slot& slot);
+    int PickHighest(SlotState state) const;  // m_Mutex held
+
+    JobSystem* m_Jobs;
+    AssetArchive* m_Assets;
+    GLuint m_IconArray = 0;
+    TexFormat m_Format = TexFormat::RGBA8;
+    int m_Levels = 1;
+
+    mutable std::mutex m_Mutex;
+    Slot m_Slots[(int)IconId::Count];
+    int m_DecodesInFlight = 0;
+};
@@ -3,44 +3,28 @@
 #include <GLFW/glfw3.h>
 #include <iostream>
 
-static void APIENTRY OpenGLDebugCallback(
-    GLenum source,
-    GLenum type,
-    GLuint id,
-    GLenum severity,
-    GLsizei length,
-    const GLchar* message,
-    const void* userParam)
-{
-    std::cerr << "[OpenGL] " << message << std::endl;
-}
-
-WinWindow::WinWindow(int width, int height, const std::string& title)
+WinWindow::WinWindow(int width, int height, const std::string& title, GLDebugMode debugMode)
 {
     glfwInit();
 
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, debugMode != GLDebugMode::Off ? GL_TRUE : GL_FALSE);
 
     m_Window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    glfwMakeContextCurrent(m_Window);
-
-    //gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
-
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    if (!m_Window)
     {
-        std::cerr << "Failed to initialize GLAD\n";
+        std::cerr << "[Window] Failed to create a GL 4.6 window" << std::endl;
         return;
     }
+    glfwMakeContextCurrent(m_Window);
 
-    // DEBUG INIT
-    glEnable(GL_DEBUG_OUTPUT);
-    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
-    glDebugMessageCallback(OpenGLDebugCallback, nullptr);
+    //gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
 
-    std::cout << "OpenGL: " << glGetString(GL_VERSION) << std::endl;
+    if (!LoadGL((GLADloadproc)glfwGetProcAddress, debugMode))
+        return;
+    m_Open = true;
 
     glfwGetFramebufferSize(m_Window, &width, &height);
     glViewport(0, 0, width, height);
@@ -48,17 +32,46 @@ WinWindow::WinWindow(int width, int height, const std::string& title)
 
 WinWindow::~WinWindow()
 {
-    glfwDestroyWindow(m_Window);
+    if (m_Window)
+        glfwDestroyWindow(m_Window);
     glfwTerminate();
 }
 
-void WinWindow::OnUpdate()
+void WinWindow::SwapBuffers()
 {
     glfwSwapBuffers(m_Window);
-    glfwPollEvents();
+}
+
+void WinWindow::PollEvents(double timeout)
+{
+    // Must be called from the main thread (GLFW requirement)
+    glfwWaitEventsTimeout(timeout);
+}
+
+void WinWindow::MakeContextCurrent()
+{
+    glfwMakeContextCurrent(m_Window);
+}
+
+void WinWindow::ReleaseContext()
+{
+    glfwMakeContextCurrent(nullptr);
 }
 
 bool WinWindow::ShouldClose() const
 {
     return glfwWindowShouldClose(m_Window);
 }
+
+bool WinWindow::IsKeyDown(Key key) const
+{
+    int glfwKey = GLFW_KEY_UNKNOWN;
+    switch (key)
+    {
+        case Key::Enter: glfwKey = GLFW_KEY_ENTER; break;
+        case Key::A:     glfwKey = GLFW_KEY_A; break;
+        case Key::D:     glfwKey = GLFW_KEY_D; break;
+        case Key::S:     glfwKey = GLFW_KEY_S; break;
+    }
+    return glfwGetKey(m_Window, glfwKey) == GLFW_PRESS;
+}
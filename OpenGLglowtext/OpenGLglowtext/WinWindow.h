@@ -1,19 +1,29 @@
 #pragma once
+#include "PlatformWindow.h"
 #include <string>
 
 struct GLFWwindow;
 
-class WinWindow
+class WinWindow : public PlatformWindow
 {
 public:
-    WinWindow(int width, int height, const std::string& title);
-    ~WinWindow();
+    WinWindow(int width, int height, const std::string& title, GLDebugMode debugMode);
+    ~WinWindow() override;
 
-    void OnUpdate();
-    bool ShouldClose() const;
+    bool IsOpen() const override { return m_Open; }
+
+    void SwapBuffers() override;
+    void PollEvents(double timeout) override;
+    bool ShouldClose() const override;
+
+    void MakeContextCurrent() override;
+    void ReleaseContext() override;
+
+    bool IsKeyDown(Key key) const override;
 
     GLFWwindow* GetNativeWindow() const { return m_Window; }
 
 private:
     GLFWwindow* m_Window;
+    bool m_Open = false;
 };
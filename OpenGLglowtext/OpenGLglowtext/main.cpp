@@ -1,8 +1,333 @@
 #include "Application.h"
+#include "CpuProfiler.h"
+#include "Microbench.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iostream>
 
-int main()
+// "enter@0.5" -> Enter pressed 0.5 s after the window opened
+static bool ParsePress(const char* arg, ScriptedKey& press)
 {
-    Application app;
-    app.Run();
-    return 0;
+    std::string text(arg);
+    size_t at = text.find('@');
+    if (at == std::string::npos)
+        return false;
+
+    std::string key = text.substr(0, at);
+    if (key == "enter")  press.key = Key::Enter;
+    else if (key == "a") press.key = Key::A;
+    else if (key == "d") press.key = Key::D;
+    else if (key == "s") press.key = Key::S;
+    else return false;
+
+    press.time = atof(text.c_str() + at + 1);
+    return true;
+}
+
+// "6:3:1" -> splash, killstreak and pulse weights
+static bool ParseMix(const char* arg, int (&mix)[3])
+{
+    int parsed[3];
+    char* end = (char*)arg;
+    for (int i = 0; i < 3; i++)
+    {
+        parsed[i] = (int)strtol(i == 0 ? end : end + 1, &end, 10);
+        if (parsed[i] < 0 || *end != (i < 2 ? ':' : '\0'))
+            return false;
+    }
+    if (parsed[0] + parsed[1] + parsed[2] == 0)
+        return false;
+    std::copy(parsed, parsed + 3, mix);
+    return true;
+}
+
+// "8-40" -> 8 to 40 characters
+static bool ParseRange(const char* arg, int& min, int& max)
+{
+    char* end;
+    int from = (int)strtol(arg, &end, 10);
+    if (*end != '-')
+        return false;
+    int to = (int)strtol(end + 1, &end, 10);
+    if (*end != '\0' || from < 1 || to < from)
+        return false;
+    min = from;
+    max = to;
+    return true;
+}
+
+// "720p,4k,800x600" -> framebuffer sizes
+static bool ParseResolutions(const char* arg, std::vector<BenchResolution>& resolutions)
+{
+    std::vector<BenchResolution> parsed;
+    std::string list(arg);
+    size_t start = 0;
+    while (start <= list.size())
+    {
+        size_t end = std::min(list.find(',', start), list.size());
+        std::string item = list.substr(start, end - start);
+        if (item == "720p")         parsed.push_back({ 1280, 720 });
+        else if (item == "1080p")   parsed.push_back({ 1920, 1080 });
+        else if (item == "1440p")   parsed.push_back({ 2560, 1440 });
+        else if (item == "4k")      parsed.push_back({ 3840, 2160 });
+        else
+        {
+            char* x;
+            int width = (int)strtol(item.c_str(), &x, 10);
+            if (*x != 'x')
+                return false;
+            char* rest;
+            int height = (int)strtol(x + 1, &rest, 10);
+            if (*rest != '\0' || width < 1 || height < 1)
+                return false;
+            parsed.push_back({ width, height });
+        }
+        start = end + 1;
+    }
+    resolutions = parsed;
+    return true;
+}
+
+// "splash,typewriter" -> those scenes
+static bool ParseScenes(const char* arg, std::vector<BenchScene>& scenes)
+{
+    std::vector<BenchScene> parsed;
+    std::string list(arg);
+    size_t start = 0;
+    while (start <= list.size())
+    {
+        size_t end = std::min(list.find(',', start), list.size());
+        BenchScene scene;
+        if (!SceneFromName(std::string_view(list).substr(start, end - start), scene))
+            return false;
+        parsed.push_back(scene);
+        start = end + 1;
+    }
+    scenes = parsed;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    AppConfig config;
+    BenchConfig bench;
+    std::string tracePath;
+    bool hitchBudget = false;
+#ifndef _WIN32
+    // Only the headless backend exists here, and build hosts have no sound card
+    config.headless = true;
+    config.nullAudio = true;
+#endif
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--null-audio") == 0)
+            config.nullAudio = true;
+        else if (strcmp(argv[i], "--headless") == 0)
+            config.headless = true;
+        else if (strcmp(argv[i], "--run-for") == 0 && i + 1 < argc)
+            config.headlessRun.runFor = atof(argv[++i]);
+        else if (strcmp(argv[i], "--screenshot") == 0 && i + 1 < argc)
+            config.headlessRun.screenshotPath = argv[++i];
+        else if (strcmp(argv[i], "--gpu-timing") == 0)
+            config.gpuTiming = true;
+        else if (strcmp(argv[i], "--gpu-overlay") == 0)
+            config.gpuOverlay = true;
+        else if (strcmp(argv[i], "--gpu-timing-out") == 0 && i + 1 < argc)
+            config.gpuTimingOut = argv[++i];
+        else if (strcmp(argv[i], "--check-budgets") == 0)
+            config.checkBudgets = true;
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            config.recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            config.replayPath = argv[++i];
+        else if (strcmp(argv[i], "--replay-step") == 0 && i + 1 < argc)
+            config.replayStep = atof(argv[++i]);
+        else if (strcmp(argv[i], "--replay-out") == 0 && i + 1 < argc)
+            config.replayOut = argv[++i];
+        else if (strcmp(argv[i], "--frame-checksums") == 0)
+            config.frameChecksums = true;
+        else if (strcmp(argv[i], "--load-test") == 0 && i + 1 < argc)
+            config.load.runFor = atof(argv[++i]);
+        else if (strcmp(argv[i], "--load-rate") == 0 && i + 1 < argc)
+            config.load.rate = atof(argv[++i]);
+        else if (strcmp(argv[i], "--load-mix") == 0 && i + 1 < argc)
+        {
+            if (!ParseMix(argv[++i], config.load.mix))
+            {
+                std::cerr << "[Args] --load-mix wants <splash>:<killstreak>:<pulse> weights, got " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--load-burst") == 0 && i + 1 < argc)
+            config.load.burst = std::max(atoi(argv[++i]), 1);
+        else if (strcmp(argv[i], "--load-text") == 0 && i + 1 < argc)
+        {
+            if (!ParseRange(argv[++i], config.load.minLength, config.load.maxLength))
+            {
+                std::cerr << "[Args] --load-text wants <min>-<max> characters, got " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--load-unicode") == 0)
+            config.load.unicode = true;
+        else if (strcmp(argv[i], "--load-seed") == 0 && i + 1 < argc)
+            config.load.seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--load-out") == 0 && i + 1 < argc)
+            config.load.outPath = argv[++i];
+        else if (strcmp(argv[i], "--render-bench") == 0)
+            config.renderBench.run = true;
+        else if (strcmp(argv[i], "--render-bench-scenes") == 0 && i + 1 < argc)
+        {
+            if (!ParseScenes(argv[++i], config.renderBench.scenes))
+                std::cerr << "[Args] --render-bench-scenes wants splash, killstreak, typewriter, glowpulse or concurrent, got " << argv[i] << std::endl;
+        }
+        else if (strcmp(argv[i], "--render-bench-res") == 0 && i + 1 < argc)
+        {
+            if (!ParseResolutions(argv[++i], config.renderBench.resolutions))
+                std::cerr << "[Args] --render-bench-res wants 720p, 1080p, 1440p, 4k or <width>x<height>, got " << argv[i] << std::endl;
+        }
+        else if (strcmp(argv[i], "--render-bench-frames") == 0 && i + 1 < argc)
+            config.renderBench.frames = std::max(atoi(argv[++i]), 1);
+        else if (strcmp(argv[i], "--render-bench-step") == 0 && i + 1 < argc)
+            config.renderBench.step = atof(argv[++i]);
+        else if (strcmp(argv[i], "--render-bench-concurrent") == 0 && i + 1 < argc)
+            config.renderBench.concurrent = std::clamp(atoi(argv[++i]), 1, RenderBenchConfig::kMaxConcurrent);
+        else if (strcmp(argv[i], "--render-bench-hashes") == 0)
+            config.renderBench.hashes = true;
+        else if (strcmp(argv[i], "--render-bench-out") == 0 && i + 1 < argc)
+            config.renderBench.outPath = argv[++i];
+        else if (strcmp(argv[i], "--bench") == 0)
+            bench.run = true;
+        else if (strcmp(argv[i], "--bench-filter") == 0 && i + 1 < argc)
+            bench.filter = argv[++i];
+        else if (strcmp(argv[i], "--bench-out") == 0 && i + 1 < argc)
+            bench.outPath = argv[++i];
+        else if (strcmp(argv[i], "--gl-debug") == 0 && i + 1 < argc)
+        {
+            if (!DebugModeFromName(argv[++i], config.glDebug))
+                std::cerr << "[Args] --gl-debug wants off, async or sync, got " << argv[i] << std::endl;
+        }
+        else if (strcmp(argv[i], "--hitch-budget") == 0 && i + 1 < argc)
+        {
+            config.flight.budgetMs = std::max((float)atof(argv[++i]), 0.0f);
+            hitchBudget = true;
+        }
+        else if (strcmp(argv[i], "--hitch-dir") == 0 && i + 1 < argc)
+            config.flight.dir = argv[++i];
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (strcmp(argv[i], "--press") == 0 && i + 1 < argc)
+        {
+            ScriptedKey press;
+            if (ParsePress(argv[++i], press))
+                config.headlessRun.presses.push_back(press);
+            else
+                std::cerr << "[Args] --press wants <enter|a|d|s>@<seconds>, got " << argv[i] << std::endl;
+        }
+    }
+
+    // Only the CPU kernels, no window is opened
+    if (bench.run)
+        return RunMicrobenchmarks(bench);
+
+    if (config.renderBench.run)
+    {
+        // The scenes are the only input, and nothing is shown
+        config.headless = true;
+        if (!config.replayPath.empty() || !config.recordPath.empty() || config.load.runFor > 0.0 || !config.headlessRun.presses.empty())
+            std::cerr << "[Args] --replay, --record, --load-test and --press are ignored with --render-bench" << std::endl;
+        config.replayPath.clear();
+        config.recordPath.clear();
+        config.load.runFor = 0.0;
+        config.headlessRun.presses.clear();
+        if (config.renderBench.step <= 0.0)
+        {
+            std::cerr << "[Args] --render-bench-step wants a time above 0, using 1/60 s" << std::endl;
+            config.renderBench.step = 1.0 / 60.0;
+        }
+        if (config.renderBench.resolutions.empty())
+            config.renderBench.resolutions.push_back({ config.width, config.height });
+    }
+
+    if (!config.replayPath.empty())
+    {
+        // The recording is the only input, and nothing is shown
+        config.headless = true;
+        if (!config.headlessRun.presses.empty())
+            std::cerr << "[Args] --press is ignored with --replay" << std::endl;
+        if (!config.recordPath.empty())
+            std::cerr << "[Args] --record is ignored with --replay" << std::endl;
+        if (config.load.runFor > 0.0)
+            std::cerr << "[Args] --load-test is ignored with --replay" << std::endl;
+        config.headlessRun.presses.clear();
+        config.recordPath.clear();
+        config.load.runFor = 0.0;
+        if (config.replayStep <= 0.0)
+        {
+            std::cerr << "[Args] --replay-step wants a time above 0, using 1/60 s" << std::endl;
+            config.replayStep = 1.0 / 60.0;
+        }
+    }
+
+    if (config.load.runFor > 0.0)
+    {
+        // The run lasts as long as the load
+        config.headless = true;
+        config.headlessRun.runFor = config.load.runFor;
+        if (config.load.rate <= 0.0)
+        {
+            std::cerr << "[Args] --load-rate wants requests per second above 0, using 10" << std::endl;
+            config.load.rate = 10.0;
+        }
+    }
+
+    // Offscreen frames (replays, benchmarks, software GL) take as long as
+    // they take, the hitch recorder only runs there when asked to
+    if (config.headless && !hitchBudget)
+        config.flight.budgetMs = 0.0f;
+
+    if (!tracePath.empty())
+    {
+        if (CpuProfiler::kEnabled)
+            CpuProfiler::Start();
+        else
+            std::cerr << "[Trace] Zones are compiled out of this build (NDEBUG without NOTIFY_PROFILE), --trace is ignored" << std::endl;
+    }
+
+    int exitCode = 0;
+    if (config.renderBench.run)
+    {
+        // One run per resolution, every one with a window of that size
+        std::vector<RenderBench::SceneResult> results;
+        for (const BenchResolution& resolution : config.renderBench.resolutions)
+        {
+            config.width = resolution.width;
+            config.height = resolution.height;
+            Application app(config);
+            app.Run();
+            exitCode = std::max(exitCode, app.GetExitCode());
+            std::vector<RenderBench::SceneResult> scenes = app.GetBenchResults();
+            if (scenes.empty())
+                exitCode = 1;
+            results.insert(results.end(), scenes.begin(), scenes.end());
+        }
+        RenderBench::PrintResults(std::cout, results);
+        if (!config.renderBench.outPath.empty() && !RenderBench::WriteJson(config.renderBench.outPath, config.renderBench, results))
+            exitCode = 1;
+    }
+    else
+    {
+        Application app(config);
+        app.Run();
+        exitCode = app.GetExitCode();
+    }
+
+    // Every other thread is joined by now
+    if (CpuProfiler::IsRecording())
+        CpuProfiler::WriteTrace(tracePath);
+    return exitCode;
 }
@@ -1,4 +1,4 @@
-#version 460 core
+#version 450 core
 layout (location = 0) in vec2 a_Pos;
 layout (location = 1) in vec2 a_TexCoords;
 
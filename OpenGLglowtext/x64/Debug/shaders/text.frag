@@ -1,24 +1,25 @@
-#version 460 core
-in vec2 v_UV;
+#version 450 core
+in vec3 v_UV;
+in vec3 v_Color;
+flat in int v_IsIcon;
 out vec4 FragColor;
 
-uniform sampler2D u_Text;
-uniform vec3 u_Color;
-uniform bool u_IsIcon;
+uniform sampler2DArray u_Text;  // glyphs of the active font, one per layer
+uniform sampler2DArray u_Icons; // notification icons, one per layer
 
 void main()
 {
-    if (u_IsIcon)
+    if (v_IsIcon != 0)
     {
         // ICON MODE: Read the full color (RGBA) from the texture
-        vec4 sampledColor = texture(u_Text, v_UV);
+        vec4 sampledColor = texture(u_Icons, v_UV);
         
-        // Here we can use u_Color to tint the icon, but if it is white (1,1,1), you will see the original colors.
-        FragColor = vec4(u_Color, 1.0) * sampledColor;
+        // Here we can use the color to tint the icon, but if it is white (1,1,1), you will see the original colors.
+        FragColor = vec4(v_Color, 1.0) * sampledColor;
     }
     else
     {
         float alpha = texture(u_Text, v_UV).r;
-        FragColor = vec4(u_Color, alpha);
+        FragColor = vec4(v_Color, alpha);
     }
 }
@@ -1,12 +1,18 @@
-#version 460 core
+#version 450 core
 layout (location = 0) in vec4 a_Vertex; // pos.xy, uv.zw
+layout (location = 1) in vec2 a_Layer;  // array layer, 0 = glyph / 1 = icon
+layout (location = 2) in vec3 a_Color;
 
-out vec2 v_UV;
+out vec3 v_UV;
+out vec3 v_Color;
+flat out int v_IsIcon;
 
 uniform mat4 u_Projection;
 
 void main()
 {
     gl_Position = u_Projection * vec4(a_Vertex.xy, 0.0, 1.0);
-    v_UV = a_Vertex.zw;
+    v_UV = vec3(a_Vertex.zw, a_Layer.x);
+    v_Color = a_Color;
+    v_IsIcon = int(a_Layer.y);
 }